@@ -36,6 +36,42 @@ i64 label_counter = 0;
 i64 op_counter = 0;
 int stack_counter = 0;
 i64 register_offset = 0;
+i64 promoted_register_counter = IR_PROMOTED_REGISTERS_START;
+string_array mutated_names;
+string_array escaped_names;
+// The functions that can't be reached from the main file so they aren't compiled
+string_array pruned_functions;
+LoopContext* loop_contexts = NULL;
+i64 loop_context_count = 0;
+_Function* compiling_function = NULL;
+Expr* inline_site = NULL;
+InlineContext* inline_contexts = NULL;
+i64 inline_context_count = 0;
+// The right-hand side of the assignment that appends to a string variable in-place
+Expr* string_append_expr = NULL;
+// The path of containers that is about to be modified, each level of it is unshared
+Expr* unshare_composite_expr = NULL;
+ListBuiltin list_builtins[] = {
+    {"append", DYN_LIST_APPEND, 2, 0, V_LIST},
+    {"extend", DYN_LIST_EXTEND, 2, 0, V_LIST},
+    {"insert", DYN_LIST_INSERT, 3, 0, V_LIST},
+    {"sum", DYN_LIST_KERNEL, 1, SIMD_SUM, V_ANY},
+    {"product", DYN_LIST_KERNEL, 1, SIMD_PRODUCT, V_ANY},
+    {"min", DYN_LIST_KERNEL, 1, SIMD_MIN, V_ANY},
+    {"max", DYN_LIST_KERNEL, 1, SIMD_MAX, V_ANY},
+    {"mean", DYN_LIST_KERNEL, 1, SIMD_MEAN, V_FLOAT},
+    {"dot", DYN_LIST_KERNEL, 2, SIMD_DOT, V_ANY},
+    {"add", DYN_LIST_KERNEL, 2, SIMD_ADD, V_LIST},
+    {"sub", DYN_LIST_KERNEL, 2, SIMD_SUB, V_LIST},
+    {"mul", DYN_LIST_KERNEL, 2, SIMD_MUL, V_LIST},
+    {"div", DYN_LIST_KERNEL, 2, SIMD_DIV, V_LIST},
+    {"eq", DYN_LIST_KERNEL, 2, SIMD_EQ, V_LIST},
+    {"ne", DYN_LIST_KERNEL, 2, SIMD_NE, V_LIST},
+    {"gt", DYN_LIST_KERNEL, 2, SIMD_GT, V_LIST},
+    {"lt", DYN_LIST_KERNEL, 2, SIMD_LT, V_LIST},
+    {"ge", DYN_LIST_KERNEL, 2, SIMD_GE, V_LIST},
+    {"le", DYN_LIST_KERNEL, 2, SIMD_LE, V_LIST},
+};
 
 KaosIR* compile(ASTRoot* ast_root)
 {
@@ -45,12 +81,21 @@ KaosIR* compile(ASTRoot* ast_root)
     // Compile imports
     compileImports(ast_root, program);
 
+    // The variables that are never mutated are propagated as constants
+    collect_mutated_names(ast_root);
+
     // Declare functions in all parsed files
     declare_functions(ast_root, program);
 
     // Determine whether the functions should be inlined or not
     determine_inline_functions(ast_root);
 
+    // Determine which functions might break the loop that calls them
+    determine_breaking_functions(ast_root);
+
+    // Determine which functions can be reached from the main file
+    determine_reachable_functions(ast_root);
+
     // Compile functions in all parsed files
     compile_functions(ast_root, program);
 
@@ -63,6 +108,7 @@ KaosIR* compile(ASTRoot* ast_root)
     if (stmt_list->stmt_count > 0)
         ast_ref = stmt_list->stmts[stmt_list->stmt_count - 1]->ast;
     push_inst_(program, MAIN_PROLOG);
+    promoted_register_counter = IR_PROMOTED_REGISTERS_START;
     for (unsigned long j = stmt_list->stmt_count; 0 < j; j--) {
         Stmt* stmt = stmt_list->stmts[j - 1];
         if (
@@ -146,7 +192,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
 
     switch (stmt->kind) {
     case EchoStmt_kind:
-        compileExpr(program, stmt->v.echo_stmt->x);
+        compile_inline_site(program, stmt->v.echo_stmt->x);
         if (stmt->v.echo_stmt->mod != NULL && stmt->v.echo_stmt->mod->kind == PrettySpec_kind) {
             push_inst_(program, DYN_PRETTY_ECHO);
         } else {
@@ -154,7 +200,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
         }
         break;
     case PrintStmt_kind:
-        compileExpr(program, stmt->v.print_stmt->x);
+        compile_inline_site(program, stmt->v.print_stmt->x);
         if (stmt->v.print_stmt->mod != NULL && stmt->v.print_stmt->mod->kind == PrettySpec_kind) {
             push_inst_(program, DYN_PRETTY_PRNT);
         } else {
@@ -162,18 +208,30 @@ void compileStmt(KaosIR* program, Stmt* stmt)
         }
         break;
     case ExprStmt_kind:
-        compileExpr(program, stmt->v.expr_stmt->x);
+        compile_inline_site(program, stmt->v.expr_stmt->x);
         break;
     case DeclStmt_kind:
         compileDecl(program, stmt->v.decl_stmt->decl);
         break;
     case AssignStmt_kind: {
+        Expr* unshare_composite_backup = unshare_composite_expr;
+        if (stmt->v.assign_stmt->x->kind == IndexExpr_kind) {
+            unshare_string(program, stmt->v.assign_stmt->x->v.index_expr->x);
+            unshare_composite(program, stmt->v.assign_stmt->x);
+            unshare_composite_expr = stmt->v.assign_stmt->x->v.index_expr->x;
+        }
         compileExpr(program, stmt->v.assign_stmt->x);
+        unshare_composite_expr = unshare_composite_backup;
         push_inst_r_r(program, MOVR, R12, R5);
         push_inst_r_r(program, MOVR, R13, R11);
         push_inst_r_r(program, MOVR, R9, R2);
+        if (is_nested_index_expr(stmt->v.assign_stmt->x))
+            push_inst_r_r(program, MOVR, R14, R4);
         // shift_registers(program);
+        if (is_string_append(stmt->v.assign_stmt->x, stmt->v.assign_stmt->y))
+            string_append_expr = stmt->v.assign_stmt->y;
         compileExpr(program, stmt->v.assign_stmt->y);
+        string_append_expr = NULL;
         switch (stmt->v.assign_stmt->x->kind) {
         case Ident_kind: {
             Symbol* symbol_x = getSymbol(stmt->v.assign_stmt->x->v.ident->name);
@@ -199,10 +257,10 @@ void compileStmt(KaosIR* program, Stmt* stmt)
             )) {
                 if (symbol_y->value_type == V_FLOAT) {
                     push_inst_r_i(program, MOVI, R0, V_FLOAT);
-                    push_inst_r_r_i(program, STR, R9, R0, sizeof(long long));
+                    store_type(program, symbol_x, R9);
                 } else if (symbol_y->value_type == V_INT) {
                     push_inst_r_i(program, MOVI, R0, V_INT);
-                    push_inst_r_r_i(program, STR, R9, R0, sizeof(long long));
+                    store_type(program, symbol_x, R9);
                 }
                 symbol_x->value_type = symbol_y->value_type;
             }
@@ -211,7 +269,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
 
             if (symbol_x->type == K_ANY && set_to_target_value_type) {
                 push_inst_r_i(program, MOVI, R0, target_value_type);
-                push_inst_r_r_i(program, STR, R9, R0, sizeof(long long));
+                store_type(program, symbol_x, R9);
             }
 
             // printf("target_value_type: %d\n", target_value_type);
@@ -224,18 +282,15 @@ void compileStmt(KaosIR* program, Stmt* stmt)
                     else if (target_value_type == V_STRING)
                         push_inst_(program, DYN_STR_TO_BOOL);
                 }
-                push_inst_r_i(program, MOVI, R3, sizeof(long long));
-                push_inst_r_r_r_i(program, STXR, R9, R3, R1, sizeof(long long));
+                store_value(program, symbol_x, R9, V_BOOL);
                 break;
             case V_INT:
-                push_inst_r_i(program, MOVI, R3, sizeof(long long));
-                push_inst_r_r_r_i(program, STXR, R9, R3, R1, sizeof(long long));
+                store_value(program, symbol_x, R9, V_INT);
                 break;
             case V_FLOAT:
                 if (symbol_y != NULL && symbol_y->type == K_ANY && target_value_type != V_FLOAT)
                     push_inst_r_r(program, EXTR, R1, R1);
-                push_inst_r_i(program, MOVI, R3, sizeof(double));
-                push_inst_r_r_r_i(program, FSTXR, R9, R3, R1, sizeof(double));
+                store_value(program, symbol_x, R9, V_FLOAT);
                 break;
             case V_STRING:
                 if (symbol_y != NULL && symbol_y->type == K_ANY && target_value_type == V_BOOL)
@@ -298,6 +353,19 @@ void compileStmt(KaosIR* program, Stmt* stmt)
             break;
         }
         case IndexExpr_kind: {
+            // The container of a nested element is only known at runtime, so its tag picks the update
+            if (is_nested_index_expr(stmt->v.assign_stmt->x)) {
+                i64 dict_op = op_counter++;
+                push_inst_r_i_i(program, BEQI, R14, V_DICT, dict_op);
+                compile_list_element_store(program);
+                i64 end_op = op_counter++;
+                push_inst_i(program, JMPI_FORWARD, end_op);
+                push_inst_i(program, PATCH, dict_op);
+                push_inst_(program, DYN_DICT_KEY_UPDATE);
+                push_inst_i(program, PATCH, end_op);
+                break;
+            }
+
             Symbol* symbol = getSymbol(stmt->v.assign_stmt->x->v.index_expr->x->v.ident->name);
             // i64 addr = symbol->addr;
 
@@ -354,7 +422,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
                 push_inst_r_r_r_i(program, STXR, R5, R4, R3, sizeof(char));
                 break;
             case K_LIST:
-                push_inst_(program, DYN_LIST_INDEX_UPDATE);
+                compile_list_element_store(program);
                 break;
             case K_DICT:
                 push_inst_(program, DYN_DICT_KEY_UPDATE);
@@ -377,7 +445,12 @@ void compileStmt(KaosIR* program, Stmt* stmt)
             break;
         }
         case IndexExpr_kind: {
+            unshare_string(program, stmt->v.del_stmt->ident->v.index_expr->x);
+            unshare_composite(program, stmt->v.del_stmt->ident);
+            Expr* unshare_composite_backup = unshare_composite_expr;
+            unshare_composite_expr = stmt->v.del_stmt->ident->v.index_expr->x;
             compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->x);
+            unshare_composite_expr = unshare_composite_backup;
             push_inst_r_r(program, MOVR, R11, R1);
             compileExpr(program, stmt->v.del_stmt->ident->v.index_expr->index);
             Symbol* symbol = getSymbol(stmt->v.del_stmt->ident->v.index_expr->x->v.ident->name);
@@ -411,11 +484,16 @@ void compileStmt(KaosIR* program, Stmt* stmt)
         break;
     case ReturnStmt_kind: {
         ReturnStmt* return_stmt = stmt->v.return_stmt;
-        enum ValueType value_type = compileExpr(program, return_stmt->x) - 1;
+        if (is_tail_call(return_stmt->x)) {
+            compile_tail_call(program, return_stmt->x);
+            break;
+        }
+
+        enum ValueType value_type = compile_inline_site(program, return_stmt->x) - 1;
         function_mode->value_type = value_type;
 
         if (!return_stmt->dont_push_callx)
-            push_inst_r(program, RETR, R1);
+            compile_return(program);
 
         break;
     }
@@ -429,7 +507,7 @@ void compileStmt(KaosIR* program, Stmt* stmt)
         break;
     }
     case BreakStmt_kind: {
-        push_inst_(program, DYN_BREAK);
+        compile_break(program);
         break;
     }
     default:
@@ -441,53 +519,22 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
 {
     ast_ref = expr->ast;
 
+    // Evaluate the expressions of constant operands at compile-time
+    BasicLit folded;
+    if (expr->kind != BasicLit_kind && fold_constant_expr(expr, &folded)) {
+        // Loading a string variable is cheaper than building the string again
+        if (expr->kind == Ident_kind && folded.value_type == V_STRING) {
+            free_basic_lit_value(&folded);
+        } else {
+            compile_basic_lit(program, &folded);
+            free_basic_lit_value(&folded);
+            return folded.value_type + 1;
+        }
+    }
+
     switch (expr->kind) {
     case BasicLit_kind:
-        switch (expr->v.basic_lit->value_type) {
-        case V_BOOL:
-            push_inst_r_i(program, MOVI, R0, V_BOOL);
-            push_inst_r_i(program, MOVI, R1, expr->v.basic_lit->value.b ? 1 : 0);
-            break;
-        case V_INT:
-            push_inst_r_i(program, MOVI, R0, V_INT);
-            push_inst_r_i(program, MOVI, R1, expr->v.basic_lit->value.i);
-            break;
-        case V_FLOAT:
-            push_inst_r_i(program, MOVI, R0, V_FLOAT);
-            push_inst_r_f(program, FMOV, R1, expr->v.basic_lit->value.f);
-            break;
-        case V_STRING: {
-            /*
-              0      8                     size+8       size+9
-              +------+ +-----------------+ +-----------------+
-              | size | |     string      | | null-terminator |
-              +------+ +-----------------+ +-----------------+
-               size_t     size * char             char
-            */
-            size_t len = strlen(expr->v.basic_lit->value.s);
-            i64 addr = stack_counter++;
-            push_inst_i_i(program, ALLOCAI, addr, (len + 1) * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, REF_ALLOCAI, R1, addr);
-
-            push_inst_r_i(program, MOVI, R3, len);
-            push_inst_r_r_i(program, STR, R1, R3, sizeof(size_t));
-
-            for (size_t i = 0; i < len; i++) {
-                push_inst_r_i(program, MOVI, R2, i * sizeof(char) + sizeof(size_t));
-                push_inst_r_i(program, MOVI, R3, expr->v.basic_lit->value.s[i]);
-                push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-            }
-
-            push_inst_r_i(program, MOVI, R2, len * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, '\0');
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-
-            push_inst_r_i(program, MOVI, R0, V_STRING);
-            break;
-        }
-        default:
-            break;
-        }
+        compile_basic_lit(program, expr->v.basic_lit);
         return expr->v.basic_lit->value_type + 1;
         break;
     case Ident_kind: {
@@ -521,23 +568,54 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         break;
     }
     case BinaryExpr_kind: {
+        enum ValueType type_x = infer_expr_type(expr->v.binary_expr->x);
+        enum ValueType type_y = infer_expr_type(expr->v.binary_expr->y);
         enum ValueType type = compileExpr(program, expr->v.binary_expr->y);
         shift_registers(program);
+
+        // Anything other than a literal or a variable might clobber the right-hand operand
+        bool is_x_clobbering = expr->v.binary_expr->x->kind != BasicLit_kind && expr->v.binary_expr->x->kind != Ident_kind;
+        // An operand that isn't statically typed might hold either an integer or a float at runtime
+        bool is_y_int = type_y != V_FLOAT;
+        bool is_y_float = type_y != V_INT && type_y != V_BOOL;
         i64 addr = stack_counter++;
-        if (expr->v.binary_expr->x->kind == ParenExpr_kind || expr->v.binary_expr->x->kind == BinaryExpr_kind) {
-            push_inst_i_i(program, ALLOCAI, addr, sizeof(long long));
+        if (is_x_clobbering) {
+            push_inst_i_i(program, ALLOCAI, addr, 3 * sizeof(long long));
             push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-            push_inst_r_r_i(program, STR, R2, R1, sizeof(long long));
+            push_inst_r_r_i(program, STR, R2, R4, sizeof(long long));
+            if (is_y_int) {
+                push_inst_r_i(program, MOVI, R3, sizeof(long long));
+                push_inst_r_r_r_i(program, STXR, R2, R3, R5, sizeof(long long));
+            }
+            if (is_y_float) {
+                push_inst_r_i(program, MOVI, R3, 2 * sizeof(long long));
+                push_inst_r_r_r_i(program, FSTXR, R2, R3, R2, sizeof(double));
+            }
         }
         compileExpr(program, expr->v.binary_expr->x);
-        if (expr->v.binary_expr->x->kind == ParenExpr_kind || expr->v.binary_expr->x->kind == BinaryExpr_kind) {
+        if (is_x_clobbering) {
             shift_registers(program);
             push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-            push_inst_r_r_i(program, LDR, R5, R2, sizeof(long long));
+            push_inst_r_r_i(program, LDR, R4, R2, sizeof(long long));
+            if (is_y_int) {
+                push_inst_r_i(program, MOVI, R3, sizeof(long long));
+                push_inst_r_r_r_i(program, LDXR, R5, R2, R3, sizeof(long long));
+            }
+            if (is_y_float) {
+                push_inst_r_i(program, MOVI, R3, 2 * sizeof(long long));
+                push_inst_r_r_r_i(program, FLDXR, R2, R2, R3, sizeof(double));
+            }
         }
+
+        if (compile_static_binary_expr(program, expr->v.binary_expr->op, type_x, type_y))
+            return infer_expr_type(expr) + 1;
+
         switch (expr->v.binary_expr->op) {
         case ADD_tok:
-            push_inst_(program, DYN_ADD);
+            if (is_string_append_site(expr))
+                push_inst_(program, DYN_STR_APPEND);
+            else
+                push_inst_(program, DYN_ADD);
             break;
         case SUB_tok:
             push_inst_(program, DYN_SUB);
@@ -610,7 +688,17 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         case ADD_tok:
             break;
         case SUB_tok:
-            push_inst_(program, DYN_NEG);
+            switch (infer_expr_type(expr->v.unary_expr->x)) {
+            case V_INT:
+                push_inst_r_r(program, NEGR, R1, R1);
+                break;
+            case V_FLOAT:
+                push_inst_r_r(program, FNEGR, R1, R1);
+                break;
+            default:
+                push_inst_(program, DYN_NEG);
+                break;
+            }
             break;
         case NOT_tok:
             push_inst_(program, DYN_LNOT);
@@ -639,31 +727,34 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             push_inst_(program, DYN_STR_INDEX_ACCESS);
             push_inst_r_i(program, MOVI, R0, V_STRING);
 
-            i64 len = 1;
-            i64 addr = stack_counter++;
-            push_inst_i_i(program, ALLOCAI, addr, (len + 1) * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, REF_ALLOCAI, R1, addr);
-
-            push_inst_r_i(program, MOVI, R2, sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, len);
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(size_t));
-
-            push_inst_r_i(program, MOVI, R2, 0 * sizeof(char) + sizeof(size_t));
+            // The character is the index of its preallocated string
             push_inst_r_r_r_i(program, LDXR, R3, R5, R4, sizeof(char));
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
-
-            push_inst_r_i(program, MOVI, R2, len * sizeof(char) + sizeof(size_t));
-            push_inst_r_i(program, MOVI, R3, '\0');
-            push_inst_r_r_r_i(program, STXR, R1, R2, R3, sizeof(char));
+            push_inst_r_r_i(program, ANDI, R3, R3, 0xff);
+            push_inst_r_r_i(program, MULI, R3, R3, sizeof(cpu_char_string));
+            push_inst_r_i(program, MOVI, R1, cpu_char_string_get('\0'));
+            push_inst_r_r_r(program, ADDR, R1, R1, R3);
             break;
         }
         case V_LIST:
         case V_DICT: {
-            push_inst_r_r_r(program, DYN_COMP_ACCESS, R5, R4, R1);
-            push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
-            push_inst_r_i(program, MOVI, R3, sizeof(long long));
-            push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
-            push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+            if (is_unshare_composite_site(expr))
+                push_inst_r_r_r(program, DYN_COMP_UNSHARE_ELEMENT, R5, R4, R1);
+
+            // The element of a nested access is only known at runtime, so its tag picks the container
+            if (expr->v.index_expr->x->kind == IndexExpr_kind) {
+                i64 dict_op = op_counter++;
+                push_inst_r_i_i(program, BEQI, R4, V_DICT, dict_op);
+                compile_list_element_load(program, R5, R1);
+                i64 end_op = op_counter++;
+                push_inst_i(program, JMPI_FORWARD, end_op);
+                push_inst_i(program, PATCH, dict_op);
+                compile_dict_element_load(program, R5, R1);
+                push_inst_i(program, PATCH, end_op);
+            } else if (type1 == V_LIST) {
+                compile_list_element_load(program, R5, R1);
+            } else {
+                compile_dict_element_load(program, R5, R1);
+            }
             break;
         }
         default:
@@ -692,8 +783,7 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             // i64 addr = symbol->addr;
             if (symbol->value_type == V_REF) {
             } else {
-                push_inst_r_i(program, MOVI, R3, sizeof(long long));
-                push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+                store_value(program, symbol, R2, V_INT);
             }
         }
         if (!expr->v.incdec_expr->first) {
@@ -713,25 +803,68 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
     }
     case CompositeLit_kind: {
         /*
-          0      8              size+8
-          +------+ +-----------------+
-          | size | |    elements     |
-          +------+ +-----------------+
-           size_t      size * i64
-                        ref (list)
-                    key-value (dict)
+          0      8          16         24             32      40             size+40
+          +------+----------+----------+--------------+-------+ +-----------------+
+          | size | capacity | elements | element type | flags | |    elements     |
+          +------+----------+----------+--------------+-------+ +-----------------+
+           size_t   size_t      i64*         i64         i64        size * i64
+                                                                 ref or value (list)
+          ________________________________
+
+          0      8      16      24             size+24
+          +------+-------+-------+ +-----------------+
+          | size | index | flags | |    elements     |
+          +------+-------+-------+ +-----------------+
+           size_t   i64     i64        size * i64
+                                    key-value (dict)
         */
         ExprList* expr_list = expr->v.composite_lit->elts;
         enum ValueType value_type = expr->v.composite_lit->type->kind == ListType_kind ? V_LIST : V_DICT;
+        size_t elements_offset = value_type == V_DICT ? CPU_DICT_ENTRIES_OFFSET : CPU_LIST_HEADER_SIZE;
+        enum ValueType element_type = value_type == V_LIST ? infer_list_element_type(expr_list) : V_ANY;
         i64 list_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, list_addr, sizeof(size_t) + expr_list->expr_count * sizeof(long long));
+        push_inst_i_i(program, ALLOCAI, list_addr, elements_offset + expr_list->expr_count * sizeof(long long));
         push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
         push_inst_r_i(program, MOVI, R3, expr_list->expr_count);
         push_inst_r_r_i(program, STR, R10, R3, sizeof(size_t));
+        if (value_type == V_DICT) {
+            // The hash index is built by the runtime on the first key lookup
+            push_inst_r_i(program, MOVI, R2, CPU_DICT_INDEX_OFFSET);
+            push_inst_r_i(program, MOVI, R3, 0);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(long long));
+            // The literals are in the stack, so they are copied instead of being shared
+            push_inst_r_i(program, MOVI, R2, CPU_DICT_FLAGS_OFFSET);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(long long));
+        } else {
+            // The literal starts out full and in its inline storage, the runtime moves it on growth
+            push_inst_r_i(program, MOVI, R2, CPU_LIST_CAPACITY_OFFSET);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(size_t));
+            push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENTS_OFFSET);
+            push_inst_r_r_i(program, ADDI, R3, R10, CPU_LIST_HEADER_SIZE);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(long long));
+            push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENT_TYPE_OFFSET);
+            push_inst_r_i(program, MOVI, R3, element_type);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(long long));
+            push_inst_r_i(program, MOVI, R2, CPU_LIST_FLAGS_OFFSET);
+            push_inst_r_i(program, MOVI, R3, 0);
+            push_inst_r_r_r_i(program, STXR, R10, R2, R3, sizeof(long long));
+        }
         size_t j = 0;
         for (size_t i = expr_list->expr_count; 0 < i; i--) {
             compileExpr(program, expr_list->exprs[i - 1]);
             Expr* expr = expr_list->exprs[i - 1];
+
+            // The values of a single scalar type are stored without a ref
+            if (element_type != V_ANY) {
+                push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
+                push_inst_r_i(program, MOVI, R3, elements_offset + (j++) * sizeof(long long));
+                if (element_type == V_FLOAT)
+                    push_inst_r_r_r_i(program, FSTXR, R10, R3, R1, sizeof(double));
+                else
+                    push_inst_r_r_r_i(program, STXR, R10, R3, R1, sizeof(long long));
+                continue;
+            }
+
             i64 elt_addr = stack_counter++;
 
             switch (expr->kind) {
@@ -777,7 +910,7 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             //     value_type = V_DICT;
             // }
             push_inst_r_i(program, REF_ALLOCAI, R10, list_addr);
-            push_inst_r_i(program, MOVI, R3, sizeof(size_t) + (j++) * sizeof(long long));
+            push_inst_r_i(program, MOVI, R3, elements_offset + (j++) * sizeof(long long));
             push_inst_r_r_r_i(program, STXR, R10, R3, R2, sizeof(long long));
         }
         // compileSpec(program, expr->v.composite_lit->type);
@@ -826,33 +959,34 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         break;
     }
     case CallExpr_kind: {
-        _Function* function = NULL;
-        switch (expr->v.call_expr->fun->kind) {
-        case Ident_kind:
-            function = getFunction(expr->v.call_expr->fun->v.ident->name, NULL);
-            break;
-        case SelectorExpr_kind:
-            function = getFunction(
-                expr->v.call_expr->fun->v.selector_expr->sel->v.ident->name,
-                expr->v.call_expr->fun->v.selector_expr->x->v.ident->name
-            );
-            break;
-        default:
-            break;
+        ListBuiltin* builtin = get_list_builtin(expr);
+        if (builtin != NULL) {
+            compile_list_builtin(program, expr, builtin);
+            return builtin->result_type + 1;
         }
 
+        _Function* function = get_called_function(expr);
+        // The calls in an inlined body are resolved in the caller's module, so the bodies stay in theirs
+        bool is_inlined = function->should_inline && expr == inline_site && strcmp(
+            function->module_context,
+            module_path_stack.arr[module_path_stack.size - 1]
+        ) == 0;
+
         ExprList* expr_list = expr->v.call_expr->args;
+        if (expr_list->expr_count > IR_MAX_CALL_ARGUMENTS)
+            throw_error(E_TOO_MANY_ARGUMENTS, function->name, NULL, IR_MAX_CALL_ARGUMENTS);
 
         if (!function->is_dynamic) {
         }
 
-        i64* putargr_stack = (i64*)malloc(USHRT_MAX * 256 * sizeof(i64));
+        // Each argument is passed in a pair of registers
+        i64* putargr_stack = (i64*)malloc(expr_list->expr_count * 2 * sizeof(i64));
         i64 putargr_stack_p = 0;
 
         // Scope override generics for the function inlining
         FunctionCall* scope_override_backup = NULL;
         FunctionCall* function_inline_scope = NULL;
-        if (function->should_inline) {
+        if (is_inlined) {
             scope_override_backup = scope_override;
             startFunctionScope(function);
             function_inline_scope = scope_override;
@@ -860,24 +994,20 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             scope_override = scope_override_backup;
         }
 
+        // The parameters are passed by reference, so the callee may modify the arguments
+        for (unsigned long i = 0; i < expr_list->expr_count; i++)
+            unshare_composite(program, expr_list->exprs[i]);
+
+        Expr* unshare_composite_backup = unshare_composite_expr;
         for (unsigned long i = 0; i < expr_list->expr_count; i++) {
             register_offset = i * 2;
 
             Expr* expr = expr_list->exprs[i];
+            unshare_composite_expr = expr;
             enum ValueType value_type = compileExpr(program, expr) - 1;
+            unshare_composite_expr = unshare_composite_backup;
             Symbol* parameter = function->parameters[i];
 
-            if (function->should_inline) {
-                // Make the parameters available the inlined function's scope
-                Symbol* symbol_upper = getSymbol(expr_list->exprs[i]->v.ident->name);
-                scope_override = function_inline_scope;
-                pushExecutedFunctionStack(function_inline_scope);
-                Symbol* symbol_new = createCloneFromSymbol(parameter->name, symbol_upper->type, symbol_upper, symbol_upper->type);
-                popExecutedFunctionStack();
-                scope_override = scope_override_backup;
-                symbol_new->addr = symbol_upper->addr;
-            }
-
             // strongly_type(parameter, NULL, function, expr, value_type);
 
             enum Type type = parameter->type;
@@ -1073,33 +1203,64 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
             }
 
             register_offset = 0;
+
+            if (is_inlined) {
+                // Make the parameters available the inlined function's scope
+                Symbol* symbol_upper = expr->kind == Ident_kind ? getSymbol(expr->v.ident->name) : NULL;
+                scope_override = function_inline_scope;
+                pushExecutedFunctionStack(function_inline_scope);
+                bind_inline_parameter(program, parameter, expr, symbol_upper, value_type, i);
+                popExecutedFunctionStack();
+                scope_override = scope_override_backup;
+            }
         }
 
         if (function->is_dynamic) {
         } else {
         }
 
-        if (function->should_inline) {
+        if (is_inlined) {
+            free(putargr_stack);
+
             // Inline the function's body and decision block
             Decl* decl = function->ast;
             scope_override = function_inline_scope;
             pushExecutedFunctionStack(function_inline_scope);
+            // The parameters of the enclosing function are out of reach in the inlined body
+            _Function* compiling_function_backup = compiling_function;
+            compiling_function = NULL;
+            push_inline_context();
             compileStmt(program, decl->v.func_decl->body);
             if (decl->v.func_decl->decision != NULL)
                 compileSpec(program, decl->v.func_decl->decision);
+            pop_inline_context(program);
+            compiling_function = compiling_function_backup;
             popExecutedFunctionStack();
             scope_override = scope_override_backup;
         } else {
             push_inst_(program, PREPARE);
             for (size_t i = 0; i < putargr_stack_p; i++)
                 push_inst_r(program, PUTARGR, putargr_stack[i]);
+            free(putargr_stack);
 
             push_inst_i_i(program, CALL, function->addr, op_counter++);
 
+            if (function->call_patches_size == function->call_patches_capacity) {
+                function->call_patches_capacity = function->call_patches_capacity == 0 ? CALL_PATCHES_INITIAL_CAPACITY : function->call_patches_capacity * 2;
+                function->call_patches = (int*)realloc(function->call_patches, function->call_patches_capacity * sizeof(int));
+            }
             function->call_patches[function->call_patches_size++] = op_counter - 1;
 
             push_inst_r(program, RETVAL, R1);
-            push_inst_r_i(program, MOVI, R0, 1); // TODO: temp, set it according to function return type
+
+            if (function->may_break)
+                compile_break_check(program);
+
+            // Only the integer register is returned, so anything that isn't a boolean is tagged as an integer
+            enum ValueType return_value_type = get_function_value_type(function);
+            push_inst_r_i(program, MOVI, R0, return_value_type == V_BOOL ? V_BOOL : V_INT);
+            if (return_value_type != V_ANY)
+                return return_value_type + 1;
         }
 
         return function->value_type + 1;
@@ -1116,9 +1277,9 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         if (expr->v.decision_expr->outcome->kind == ReturnStmt_kind)
             expr->v.decision_expr->outcome->v.return_stmt->dont_push_callx = true;
 
-        compileStmt(program, expr->v.decision_expr->outcome);
+        compile_outcome(program, expr->v.decision_expr->outcome);
 
-        push_inst_r(program, RETR, R1);
+        compile_return(program);
 
         push_inst_i(program, PATCH, _op);
         break;
@@ -1128,9 +1289,9 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
         if (expr->v.default_expr->outcome->kind == ReturnStmt_kind)
             expr->v.default_expr->outcome->v.return_stmt->dont_push_callx = true;
 
-        compileStmt(program, expr->v.default_expr->outcome);
+        compile_outcome(program, expr->v.default_expr->outcome);
 
-        push_inst_r(program, RETR, R1);
+        compile_return(program);
         break;
     }
     default:
@@ -1140,13 +1301,39 @@ unsigned short compileExpr(KaosIR* program, Expr* expr)
     return 0;
 }
 
+void compile_basic_lit(KaosIR* program, BasicLit* basic_lit)
+{
+    switch (basic_lit->value_type) {
+    case V_BOOL:
+        push_inst_r_i(program, MOVI, R0, V_BOOL);
+        push_inst_r_i(program, MOVI, R1, basic_lit->value.b ? 1 : 0);
+        break;
+    case V_INT:
+        push_inst_r_i(program, MOVI, R0, V_INT);
+        push_inst_r_i(program, MOVI, R1, basic_lit->value.i);
+        break;
+    case V_FLOAT:
+        push_inst_r_i(program, MOVI, R0, V_FLOAT);
+        push_inst_r_f(program, FMOV, R1, basic_lit->value.f);
+        break;
+    case V_STRING: {
+        byte* addr = push_string_data(program, basic_lit->value.s);
+        push_inst_r_s(program, MOVI, R1, addr);
+        push_inst_r_i(program, MOVI, R0, V_STRING);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 void compileDecl(KaosIR* program, Decl* decl)
 {
     ast_ref = decl->ast;
 
     switch (decl->kind) {
     case VarDecl_kind: {
-        enum ValueType value_type = compileExpr(program, decl->v.var_decl->expr) - 1;
+        enum ValueType value_type = compile_inline_site(program, decl->v.var_decl->expr) - 1;
         enum Type type = compileSpec(program, decl->v.var_decl->type_spec);
         // enum Type secondary_type = K_ANY;
         // if (decl->v.var_decl->type_spec->v.type_spec->sub_type_spec != NULL)
@@ -1162,7 +1349,7 @@ void compileDecl(KaosIR* program, Decl* decl)
 
             if ((decl->v.var_decl->expr->kind != BinaryExpr_kind && decl->v.var_decl->expr->kind != UnaryExpr_kind))
                 push_inst_r_i(program, MOVI, R0, V_BOOL);
-            store_bool(
+            symbol = store_bool(
                 program,
                 decl->v.var_decl->ident->v.ident->name,
                 false
@@ -1172,7 +1359,7 @@ void compileDecl(KaosIR* program, Decl* decl)
             if (value_type == V_FLOAT) {
                 if ((decl->v.var_decl->expr->kind != BinaryExpr_kind && decl->v.var_decl->expr->kind != UnaryExpr_kind))
                     push_inst_r_i(program, MOVI, R0, V_FLOAT);
-                store_float(
+                symbol = store_float(
                     program,
                     decl->v.var_decl->ident->v.ident->name,
                     false
@@ -1180,7 +1367,7 @@ void compileDecl(KaosIR* program, Decl* decl)
             } else {
                 if ((decl->v.var_decl->expr->kind != BinaryExpr_kind && decl->v.var_decl->expr->kind != UnaryExpr_kind))
                     push_inst_r_i(program, MOVI, R0, V_INT);
-                store_int(
+                symbol = store_int(
                     program,
                     decl->v.var_decl->ident->v.ident->name,
                     false
@@ -1193,7 +1380,7 @@ void compileDecl(KaosIR* program, Decl* decl)
 
             if ((decl->v.var_decl->expr->kind != BinaryExpr_kind && decl->v.var_decl->expr->kind != UnaryExpr_kind))
                 push_inst_r_i(program, MOVI, R0, V_STRING);
-            store_string(
+            symbol = store_string(
                 program,
                 decl->v.var_decl->ident->v.ident->name,
                 false
@@ -1260,7 +1447,7 @@ void compileDecl(KaosIR* program, Decl* decl)
                 len = decl->v.var_decl->expr->v.composite_lit->elts->expr_count;
                 break;
             case Ident_kind:
-                is_dynamic = true;
+                is_dynamic = share_composite(program, decl->v.var_decl->expr);
                 break;
             default:
                 break;
@@ -1283,7 +1470,7 @@ void compileDecl(KaosIR* program, Decl* decl)
                 len = decl->v.var_decl->expr->v.composite_lit->elts->expr_count;
                 break;
             case Ident_kind:
-                is_dynamic = true;
+                is_dynamic = share_composite(program, decl->v.var_decl->expr);
                 break;
             default:
                 break;
@@ -1298,41 +1485,45 @@ void compileDecl(KaosIR* program, Decl* decl)
             break;
         }
         }
+
+        BasicLit folded;
+        if (symbol != NULL && symbol->type != K_ANY && fold_constant_expr(decl->v.var_decl->expr, &folded)) {
+            if (folded.value_type == symbol->value_type && can_be_constant(symbol->name, folded.value_type)) {
+                symbol->is_constant = true;
+                symbol->value = folded.value;
+            } else {
+                free_basic_lit_value(&folded);
+            }
+        }
         break;
     }
     case TimesDo_kind: {
         Symbol* index_symbol = NULL;
-        i64 len_addr = 0;
 
         compileExpr(program, decl->v.times_do->x);
 
-        i64 addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        // The loop counters never escape so they are kept in the registers, which are free again after the loop
+        i64 promoted_register_backup = promoted_register_counter;
+        i64 counter_reg = promoted_register_counter++;
+        i64 len_reg = promoted_register_counter++;
+        push_inst_r_r(program, MOVR, counter_reg, R1);
 
-        if (decl->v.times_do->index != NULL) {
-            len_addr = stack_counter++;
-            push_inst_i_i(program, ALLOCAI, len_addr, 1 * sizeof(i64));
-            push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-            push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
-        }
+        if (decl->v.times_do->index != NULL)
+            push_inst_r_r(program, MOVR, len_reg, R1);
 
         i64 loop_start = label_counter++;
         push_inst_i(program, DECLARE_LABEL, loop_start);
 
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
+        push_inst_r_r(program, MOVR, R1, counter_reg);
 
         i64 loop_end = op_counter++;
         push_inst_r_i_i(program, BEQI, R1, 0, loop_end);
 
         push_inst_r_r_i(program, SUBI, R1, R1, 1);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        push_inst_r_r(program, MOVR, counter_reg, R1);
 
         if (decl->v.times_do->index != NULL) {
-            push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-            push_inst_r_r_i(program, LDR, R3, R2, sizeof(i64));
+            push_inst_r_r(program, MOVR, R3, len_reg);
             push_inst_r_r_i(program, ADDI, R1, R1, 1);
             push_inst_r_r_r(program, SUBR, R1, R3, R1);
             push_inst_r_i(program, MOVI, R0, V_INT);
@@ -1343,19 +1534,17 @@ void compileDecl(KaosIR* program, Decl* decl)
             );
         }
 
-        compileExpr(program, decl->v.times_do->call_expr);
+        push_loop_context();
+        compile_inline_site(program, decl->v.times_do->call_expr);
 
         if (decl->v.times_do->index != NULL) {
             removeSymbol(index_symbol);
         }
 
-        push_inst_(program, DYN_BREAK_HANDLE);
-        i64 loop_end_break = op_counter++;
-        push_inst_r_i_i(program, BEQI, R1, 1, loop_end_break);
-
         push_inst_i(program, JMPI, loop_start);
         push_inst_i(program, PATCH, loop_end);
-        push_inst_i(program, PATCH, loop_end_break);
+        pop_loop_context(program);
+        promoted_register_counter = promoted_register_backup;
         break;
     }
     case ForeachAsList_kind: {
@@ -1374,41 +1563,40 @@ void compileDecl(KaosIR* program, Decl* decl)
             break;
         }
 
-        i64 addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        i64 promoted_register_backup = promoted_register_counter;
+        i64 comp_reg = promoted_register_counter++;
+        i64 len_reg = promoted_register_counter++;
+        i64 len_bak_reg = promoted_register_counter++;
+        i64 element_type_reg = promoted_register_counter++;
+        i64 elements_reg = promoted_register_counter++;
+        push_inst_r_r(program, MOVR, comp_reg, R1);
 
-        push_inst_r_r(program, DYN_GET_COMP_SIZE, R1, R1);
+        // The element type and the elements of a list that the loop can't mutate are loaded only once
+        bool is_invariant = is_invariant_composite(decl->v.foreach_as_list->x, decl->v.foreach_as_list->call_expr);
+        if (is_invariant)
+            compile_list_elements_load(program, comp_reg, element_type_reg, elements_reg);
 
-        i64 len_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, len_addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        push_inst_r_r(program, DYN_GET_COMP_SIZE, R1, R1);
 
-        i64 len_bak_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, len_bak_addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R3, len_bak_addr);
-        push_inst_r_r_i(program, STR, R3, R1, sizeof(i64));
+        push_inst_r_r(program, MOVR, len_reg, R1);
+        push_inst_r_r(program, MOVR, len_bak_reg, R1);
 
         i64 loop_start = label_counter++;
         push_inst_i(program, DECLARE_LABEL, loop_start);
 
-        push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-        push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
+        push_inst_r_r(program, MOVR, R1, len_reg);
 
-        push_inst_r_i(program, REF_ALLOCAI, R3, len_bak_addr);
-        push_inst_r_r_i(program, LDR, R11, R3, sizeof(i64));
+        push_inst_r_r(program, MOVR, R11, len_bak_reg);
         push_inst_r_r_r(program, SUBR, R11, R11, R1);
 
         i64 loop_end = op_counter++;
         push_inst_r_i_i(program, BEQI, R1, 0, loop_end);
 
         push_inst_r_r_i(program, SUBI, R1, R1, 1);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        push_inst_r_r(program, MOVR, len_reg, R1);
 
         if (decl->v.foreach_as_list->index != NULL) {
-            push_inst_r_r_i(program, LDR, R3, R3, sizeof(i64));
+            push_inst_r_r(program, MOVR, R3, len_bak_reg);
             push_inst_r_r_i(program, ADDI, R1, R1, 1);
             push_inst_r_r_r(program, SUBR, R1, R3, R1);
             push_inst_r_i(program, MOVI, R0, V_INT);
@@ -1419,22 +1607,17 @@ void compileDecl(KaosIR* program, Decl* decl)
             );
         }
 
-        push_inst_r_i(program, MOVI, R0, V_LIST);
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
-
-        push_inst_r_r_r(program, DYN_COMP_ACCESS, R1, R0, R11);
-        push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
-        push_inst_r_i(program, MOVI, R3, sizeof(long long));
-        push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
-        push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+        if (!is_invariant)
+            compile_list_elements_load(program, comp_reg, element_type_reg, elements_reg);
+        compile_foreach_element_load(program, element_type_reg, elements_reg, R11);
 
         Symbol* el_symbol = store_any(
             program,
             decl->v.foreach_as_list->el->v.ident->name
         );
 
-        compileExpr(program, decl->v.foreach_as_list->call_expr);
+        push_loop_context();
+        compile_inline_site(program, decl->v.foreach_as_list->call_expr);
 
         if (decl->v.foreach_as_list->index != NULL) {
             removeSymbol(index_symbol);
@@ -1442,13 +1625,10 @@ void compileDecl(KaosIR* program, Decl* decl)
 
         removeSymbol(el_symbol);
 
-        push_inst_(program, DYN_BREAK_HANDLE);
-        i64 loop_end_break = op_counter++;
-        push_inst_r_i_i(program, BEQI, R1, 1, loop_end_break);
-
         push_inst_i(program, JMPI, loop_start);
         push_inst_i(program, PATCH, loop_end);
-        push_inst_i(program, PATCH, loop_end_break);
+        pop_loop_context(program);
+        promoted_register_counter = promoted_register_backup;
         break;
     }
     case ForeachAsDict_kind: {
@@ -1467,41 +1647,37 @@ void compileDecl(KaosIR* program, Decl* decl)
             break;
         }
 
-        i64 addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        i64 promoted_register_backup = promoted_register_counter;
+        i64 comp_reg = promoted_register_counter++;
+        i64 len_reg = promoted_register_counter++;
+        i64 len_bak_reg = promoted_register_counter++;
+        i64 entries_reg = promoted_register_counter++;
+        push_inst_r_r(program, MOVR, comp_reg, R1);
 
-        push_inst_r_r(program, DYN_GET_COMP_SIZE, R1, R1);
+        // The key-value pairs are kept in the insertion order after the hash index
+        push_inst_r_r_i(program, ADDI, entries_reg, comp_reg, CPU_DICT_ENTRIES_OFFSET);
 
-        i64 len_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, len_addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        push_inst_r_r(program, DYN_GET_COMP_SIZE, R1, R1);
 
-        i64 len_bak_addr = stack_counter++;
-        push_inst_i_i(program, ALLOCAI, len_bak_addr, 1 * sizeof(i64));
-        push_inst_r_i(program, REF_ALLOCAI, R3, len_bak_addr);
-        push_inst_r_r_i(program, STR, R3, R1, sizeof(i64));
+        push_inst_r_r(program, MOVR, len_reg, R1);
+        push_inst_r_r(program, MOVR, len_bak_reg, R1);
 
         i64 loop_start = label_counter++;
         push_inst_i(program, DECLARE_LABEL, loop_start);
 
-        push_inst_r_i(program, REF_ALLOCAI, R2, len_addr);
-        push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
+        push_inst_r_r(program, MOVR, R1, len_reg);
 
-        push_inst_r_i(program, REF_ALLOCAI, R3, len_bak_addr);
-        push_inst_r_r_i(program, LDR, R11, R3, sizeof(i64));
+        push_inst_r_r(program, MOVR, R11, len_bak_reg);
         push_inst_r_r_r(program, SUBR, R11, R11, R1);
 
         i64 loop_end = op_counter++;
         push_inst_r_i_i(program, BEQI, R1, 0, loop_end);
 
         push_inst_r_r_i(program, SUBI, R1, R1, 1);
-        push_inst_r_r_i(program, STR, R2, R1, sizeof(i64));
+        push_inst_r_r(program, MOVR, len_reg, R1);
 
         if (decl->v.foreach_as_dict->index != NULL) {
-            push_inst_r_r_i(program, LDR, R3, R3, sizeof(i64));
+            push_inst_r_r(program, MOVR, R3, len_bak_reg);
             push_inst_r_r_i(program, ADDI, R1, R1, 1);
             push_inst_r_r_r(program, SUBR, R1, R3, R1);
             push_inst_r_i(program, MOVI, R0, V_INT);
@@ -1512,12 +1688,8 @@ void compileDecl(KaosIR* program, Decl* decl)
             );
         }
 
-        // Don't worry `V_LIST` was intentional
-        push_inst_r_i(program, MOVI, R0, V_LIST);
-        push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-        push_inst_r_r_i(program, LDR, R1, R2, sizeof(i64));
-
-        push_inst_r_r_r(program, DYN_COMP_ACCESS, R1, R0, R11);
+        push_inst_r_r_i(program, MULI, R3, R11, sizeof(long long));
+        push_inst_r_r_r_i(program, LDXR, R2, entries_reg, R3, sizeof(long long));
         push_inst_r_r_i(program, LDR, R11, R2, sizeof(long long));
         push_inst_r_i(program, MOVI, R3, sizeof(long long));
         push_inst_r_r_r_i(program, LDXR, R12, R2, R3, sizeof(long long));
@@ -1541,7 +1713,8 @@ void compileDecl(KaosIR* program, Decl* decl)
             decl->v.foreach_as_dict->value->v.ident->name
         );
 
-        compileExpr(program, decl->v.foreach_as_dict->call_expr);
+        push_loop_context();
+        compile_inline_site(program, decl->v.foreach_as_dict->call_expr);
 
         if (decl->v.foreach_as_dict->index != NULL) {
             removeSymbol(index_symbol);
@@ -1550,24 +1723,14 @@ void compileDecl(KaosIR* program, Decl* decl)
         removeSymbol(key_symbol);
         removeSymbol(value_symbol);
 
-        push_inst_(program, DYN_BREAK_HANDLE);
-        i64 loop_end_break = op_counter++;
-        push_inst_r_i_i(program, BEQI, R1, 1, loop_end_break);
-
         push_inst_i(program, JMPI, loop_start);
         push_inst_i(program, PATCH, loop_end);
-        push_inst_i(program, PATCH, loop_end_break);
+        pop_loop_context(program);
+        promoted_register_counter = promoted_register_backup;
         break;
     }
     case FuncDecl_kind: {
         _Function* function = startFunctionNew(decl->v.func_decl->name->v.ident->name);
-        if (function->should_inline) {
-            function->ast = decl;
-            function_mode->is_compiled = true;
-            endFunction();
-            break;
-        }
-
         function->ast = decl;
 
         if (function->is_compiled)
@@ -1577,11 +1740,21 @@ void compileDecl(KaosIR* program, Decl* decl)
             push_inst_i(program, PATCH, function->call_patches[i]);
 
         push_inst_i(program, PROLOG, function->addr);
+        promoted_register_counter = IR_PROMOTED_REGISTERS_START;
 
         compileSpec(program, decl->v.func_decl->type->v.func_type->params);
 
         for (int i = 0; i < function->parameter_count; i++) {
             Symbol* parameter = function->parameters[i];
+            parameter->value_type = V_INT;  // TODO: temp, set it according to parameter type
+
+            if (parameter->type == K_BOOL || parameter->type == K_NUMBER) {
+                promote_symbol(parameter);
+                push_inst_r_i(program, GETARG, parameter->reg, (i * 2));
+                push_inst_r_i(program, GETARG, parameter->reg + 1, (i * 2) + 1);
+                continue;
+            }
+
             push_inst_r_i(program, GETARG, R0, (i * 2));
             push_inst_r_i(program, GETARG, R1, (i * 2) + 1);
 
@@ -1591,12 +1764,17 @@ void compileDecl(KaosIR* program, Decl* decl)
             push_inst_r_r_i(program, STR, R2, R0, sizeof(long long));
             push_inst_r_i(program, MOVI, R3, sizeof(long long));
             push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
-            parameter->value_type = V_INT;  // TODO: temp, set it according to parameter type
         }
 
+        // Self tail calls overwrite the parameters and jump back here
+        function->body_addr = label_counter++;
+        push_inst_i(program, DECLARE_LABEL, function->body_addr);
+
+        compiling_function = function;
         compileStmt(program, decl->v.func_decl->body);
         if (decl->v.func_decl->decision != NULL)
             compileSpec(program, decl->v.func_decl->decision);
+        compiling_function = NULL;
 
         function_mode->is_compiled = true;
         endFunction();
@@ -1994,343 +2172,214 @@ unsigned short compileSpec(KaosIR* program, Spec* spec)
     return 0;
 }
 
-void push_inst_(KaosIR* program, enum IROpCode op_code)
+enum IRRegister offset_register(enum IRRegister reg)
 {
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->ast = ast_ref;
+    if (reg >= IR_PROMOTED_REGISTERS_START)
+        return reg;
+    return reg + register_offset;
+}
 
-    pushProgram(program, inst);
+void push_inst_(KaosIR* program, enum IROpCode op_code)
+{
+    pushProgram(program, op_code);
 }
 
 void push_inst_i(KaosIR* program, enum IROpCode op_code, i64 i)
 {
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_VAL;
-    union IRValue value1;
-    value1.i = i;
-    op1->value = value1;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_VAL;
+    inst->op1.value.i = i;
 }
 
 void push_inst_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg)
 {
-    reg += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->ast = ast_ref;
+    reg = offset_register(reg);
 
-    pushProgram(program, inst);
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg;
 }
 
 void push_inst_i_i(KaosIR* program, enum IROpCode op_code, i64 i1, i64 i2)
 {
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_VAL;
-    union IRValue value1;
-    value1.i = i1;
-    op1->value = value1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_VAL;
-    union IRValue value2;
-    value2.i = i2;
-    op2->value = value2;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_VAL;
+    inst->op1.value.i = i1;
+    inst->op2.type = IR_VAL;
+    inst->op2.value.i = i2;
 }
 
 void push_inst_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, i64 i)
 {
-    reg += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_VAL;
-    union IRValue value2;
-    value2.i = i;
-    op2->value = value2;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->ast = ast_ref;
+    reg = offset_register(reg);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg;
+    inst->op2.type = IR_VAL;
+    inst->op2.value_type = IR_INT;
+    inst->op2.value.i = i;
+}
 
-    pushProgram(program, inst);
+void push_inst_r_s(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, byte* addr)
+{
+    reg = offset_register(reg);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg;
+    inst->op2.type = IR_VAL;
+    inst->op2.value_type = IR_STRING;
+    inst->op2.value.s = addr;
 }
 
 void push_inst_r_f(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, f64 f)
 {
-    reg += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_VAL;
-    union IRValue value2;
-    value2.f = f;
-    op2->value = value2;
+    reg = offset_register(reg);
 
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg;
+    inst->op2.type = IR_VAL;
+    inst->op2.value.f = f;
 }
 
 void push_inst_r_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
 }
 
 void push_inst_r_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, i64 i)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_VAL;
-    union IRValue value3;
-    value3.i = i;
-    op3->value = value3;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
+    inst->op3.type = IR_VAL;
+    inst->op3.value.i = i;
 }
 
 void push_inst_r_i_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, i64 i1, i64 i2)
 {
-    reg1 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_VAL;
-    union IRValue value2;
-    value2.i = i1;
-    op2->value = value2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_VAL;
-    union IRValue value3;
-    value3.i = i2;
-    op3->value = value3;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_VAL;
+    inst->op2.value.i = i1;
+    inst->op3.type = IR_VAL;
+    inst->op3.value.i = i2;
 }
 
 void push_inst_r_r_f(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, f64 f)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_VAL;
-    union IRValue value3;
-    value3.f = f;
-    op3->value = value3;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
+    inst->op3.type = IR_VAL;
+    inst->op3.value.f = f;
 }
 
 void push_inst_r_r_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, enum IRRegister reg3)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-    reg3 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_REG;
-    op3->reg = reg3;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+    reg3 = offset_register(reg3);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
+    inst->op3.type = IR_REG;
+    inst->op3.reg = reg3;
 }
 
 void push_inst_r_r_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, enum IRRegister reg3, i64 i)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-    reg3 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_REG;
-    op3->reg = reg3;
-
-    KaosOp* op4 = malloc(sizeof *op4);
-    op4->type = IR_VAL;
-    union IRValue value4;
-    value4.i = i;
-    op4->value = value4;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->op4 = op4;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+    reg3 = offset_register(reg3);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
+    inst->op3.type = IR_REG;
+    inst->op3.reg = reg3;
+    inst->op4.type = IR_VAL;
+    inst->op4.value.i = i;
 }
 
 void push_inst_r_r_r_f(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, enum IRRegister reg3, f64 f)
 {
-    reg1 += register_offset;
-    reg2 += register_offset;
-    reg3 += register_offset;
-
-    KaosOp* op1 = malloc(sizeof *op1);
-    op1->type = IR_REG;
-    op1->reg = reg1;
-
-    KaosOp* op2 = malloc(sizeof *op2);
-    op2->type = IR_REG;
-    op2->reg = reg2;
-
-    KaosOp* op3 = malloc(sizeof *op3);
-    op3->type = IR_REG;
-    op3->reg = reg3;
-
-    KaosOp* op4 = malloc(sizeof *op4);
-    op4->type = IR_VAL;
-    union IRValue value4;
-    value4.f = f;
-    op4->value = value4;
-
-    KaosInst* inst = malloc(sizeof *inst);
-    inst->op_code = op_code;
-    inst->op1 = op1;
-    inst->op2 = op2;
-    inst->op3 = op3;
-    inst->op4 = op4;
-    inst->ast = ast_ref;
-
-    pushProgram(program, inst);
+    reg1 = offset_register(reg1);
+    reg2 = offset_register(reg2);
+    reg3 = offset_register(reg3);
+
+    KaosInst* inst = pushProgram(program, op_code);
+    inst->op1.type = IR_REG;
+    inst->op1.reg = reg1;
+    inst->op2.type = IR_REG;
+    inst->op2.reg = reg2;
+    inst->op3.type = IR_REG;
+    inst->op3.reg = reg3;
+    inst->op4.type = IR_VAL;
+    inst->op4.value.f = f;
 }
 
-void pushProgram(KaosIR* program, KaosInst* inst)
+KaosInst* pushProgram(KaosIR* program, enum IROpCode op_code)
 {
-    if (program->capacity == 0) {
-        program->arr = (KaosInst**)malloc((++program->capacity) * sizeof(KaosInst*));
-    } else {
-        program->arr = (KaosInst**)realloc(program->arr, (++program->capacity) * sizeof(KaosInst*));
+    if (program->size == program->capacity) {
+        program->capacity = program->capacity == 0 ? IR_INITIAL_CAPACITY : program->capacity * 2;
+        program->arr = (KaosInst*)realloc(program->arr, program->capacity * sizeof(KaosInst));
     }
-    program->arr[program->size++] = inst;
+
+    KaosInst* inst = &program->arr[program->size++];
+    memset(inst, 0, sizeof *inst);
+    inst->op_code = op_code;
+    inst->ast = ast_ref;
+    return inst;
 }
 
 KaosInst* popProgram(KaosIR* program)
 {
-    return program->arr[program->size--];
+    return &program->arr[--program->size];
 }
 
 void freeProgram(KaosIR* program)
 {
     free(program->arr);
-    initProgram(program);
+    for (i64 i = 0; i < program->data_count; i++) {
+        free(program->data[i]->arr);
+        free(program->data[i]);
+    }
+    free(program->data);
+
+    program->capacity = 0;
+    program->arr = NULL;
+    program->size = 0;
+    program->hlt_count = 0;
+    program->data = NULL;
+    program->data_count = 0;
 }
 
 KaosIR* initProgram()
@@ -2340,10 +2389,49 @@ KaosIR* initProgram()
     program->arr = NULL;
     program->size = 0;
     program->hlt_count = 0;
+    program->data = NULL;
+    program->data_count = 0;
 
     return program;
 }
 
+byte* push_string_data(KaosIR* program, char *s)
+{
+    /*
+      -16    -8      0      8                     size+8       size+9
+      +------+-------+------+ +-----------------+ +-----------------+
+      | hash | flags | size | |     string      | | null-terminator |
+      +------+-------+------+ +-----------------+ +-----------------+
+        u64     u64   size_t     size * char             char
+    */
+    size_t len = strlen(s);
+    i64 size = sizeof(cpu_string_header) + sizeof(size_t) + (len + 1) * sizeof(char);
+    // Keep the size fields aligned
+    size = (size + sizeof(size_t) - 1) & ~(i64)(sizeof(size_t) - 1);
+
+    KaosData* data = program->data_count > 0 ? program->data[program->data_count - 1] : NULL;
+    if (data == NULL || data->size + size > data->capacity) {
+        data = malloc(sizeof *data);
+        data->capacity = size > IR_DATA_CHUNK_SIZE ? size : IR_DATA_CHUNK_SIZE;
+        data->arr = malloc(data->capacity);
+        data->size = 0;
+        program->data = realloc(program->data, (program->data_count + 1) * sizeof(KaosData*));
+        program->data[program->data_count++] = data;
+    }
+
+    // The literals are hashed upfront since they can't change
+    cpu_string_header* header = (cpu_string_header*)(data->arr + data->size);
+    header->hash = cpu_string_hash(s);
+    header->flags = CPU_STRING_HASHED | CPU_STRING_CONSTANT;
+
+    byte* addr = data->arr + data->size + sizeof(cpu_string_header);
+    *(size_t*)addr = len;
+    memcpy(addr + sizeof(size_t), s, (len + 1) * sizeof(char));
+    data->size += size;
+
+    return addr;
+}
+
 void shift_registers(KaosIR* program)
 {
     i64 shift = 4;
@@ -2371,6 +2459,13 @@ Symbol* store_bool(KaosIR* program, char *name, bool is_any)
     else {
         symbol = addSymbol(name, K_BOOL, value, V_BOOL);
     }
+    if (!is_any) {
+        promote_symbol(symbol);
+        store_type(program, symbol, R2);
+        store_value(program, symbol, R2, V_BOOL);
+        return symbol;
+    }
+
     symbol->addr = stack_counter++;
     push_inst_i_i(program, ALLOCAI, symbol->addr, 2 * sizeof(long long));
     push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
@@ -2398,6 +2493,13 @@ Symbol* store_int(KaosIR* program, char *name, bool is_any)
     else {
         symbol = addSymbol(name, K_NUMBER, value, V_INT);
     }
+    if (!is_any) {
+        promote_symbol(symbol);
+        store_type(program, symbol, R2);
+        store_value(program, symbol, R2, V_INT);
+        return symbol;
+    }
+
     symbol->addr = stack_counter++;
     push_inst_i_i(program, ALLOCAI, symbol->addr, 2 * sizeof(long long));
     push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
@@ -2425,6 +2527,13 @@ Symbol* store_float(KaosIR* program, char *name, bool is_any)
     else {
         symbol = addSymbol(name, K_NUMBER, value, V_FLOAT);
     }
+    if (!is_any) {
+        promote_symbol(symbol);
+        store_type(program, symbol, R2);
+        store_value(program, symbol, R2, V_FLOAT);
+        return symbol;
+    }
+
     symbol->addr = stack_counter++;
     push_inst_i_i(program, ALLOCAI, symbol->addr, 2 * sizeof(double));
     push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
@@ -2545,17 +2654,69 @@ Symbol* store_any(KaosIR* program, char *name)
     return symbol;
 }
 
-void load_bool(KaosIR* program, Symbol* symbol)
+void promote_symbol(Symbol* symbol)
 {
-    i64 addr = symbol->addr;
-    push_inst_r_i(program, REF_ALLOCAI, R2, addr);
-    push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
-    push_inst_r_i(program, MOVI, R3, sizeof(long long));
-    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    /*
+      +------+-------+
+      | type | value |
+      +------+-------+
+         R      R/FR
+       reg    reg + 1
+    */
+    symbol->reg = promoted_register_counter;
+    promoted_register_counter += 2;
+}
+
+void store_type(KaosIR* program, Symbol* symbol, enum IRRegister addr_reg)
+{
+    if (symbol->reg != 0)
+        push_inst_r_r(program, MOVR, symbol->reg, R0);
+    else
+        push_inst_r_r_i(program, STR, addr_reg, R0, sizeof(long long));
+}
+
+void store_value(KaosIR* program, Symbol* symbol, enum IRRegister addr_reg, enum ValueType value_type)
+{
+    if (symbol->reg != 0) {
+        if (value_type == V_FLOAT)
+            push_inst_r_r(program, FMOVR, symbol->reg + 1, R1);
+        else
+            push_inst_r_r(program, MOVR, symbol->reg + 1, R1);
+        return;
+    }
+
+    if (value_type == V_FLOAT) {
+        push_inst_r_i(program, MOVI, R3, sizeof(double));
+        push_inst_r_r_r_i(program, FSTXR, addr_reg, R3, R1, sizeof(double));
+    } else {
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, STXR, addr_reg, R3, R1, sizeof(long long));
+    }
+}
+
+void load_bool(KaosIR* program, Symbol* symbol)
+{
+    if (symbol->reg != 0) {
+        push_inst_r_r(program, MOVR, R0, symbol->reg);
+        push_inst_r_r(program, MOVR, R1, symbol->reg + 1);
+        return;
+    }
+
+    i64 addr = symbol->addr;
+    push_inst_r_i(program, REF_ALLOCAI, R2, addr);
+    push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
 }
 
 void load_int(KaosIR* program, Symbol* symbol)
 {
+    if (symbol->reg != 0) {
+        push_inst_r_r(program, MOVR, R0, symbol->reg);
+        push_inst_r_r(program, MOVR, R1, symbol->reg + 1);
+        return;
+    }
+
     i64 addr = symbol->addr;
     push_inst_r_i(program, REF_ALLOCAI, R2, addr);
     push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
@@ -2565,6 +2726,12 @@ void load_int(KaosIR* program, Symbol* symbol)
 
 void load_float(KaosIR* program, Symbol* symbol)
 {
+    if (symbol->reg != 0) {
+        push_inst_r_r(program, MOVR, R0, symbol->reg);
+        push_inst_r_r(program, FMOVR, R1, symbol->reg + 1);
+        return;
+    }
+
     i64 addr = symbol->addr;
     push_inst_r_i(program, REF_ALLOCAI, R2, addr);
     push_inst_r_r_i(program, LDR, R0, R2, sizeof(double));
@@ -2581,6 +2748,61 @@ void load_string(KaosIR* program, Symbol* symbol)
     push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
 }
 
+// String literals live in the read-only constant data, take a copy before modifying one in-place
+void unshare_string(KaosIR* program, Expr* expr)
+{
+    if (expr->kind != Ident_kind)
+        return;
+
+    Symbol* symbol = getSymbol(expr->v.ident->name);
+    if (symbol->type != K_STRING)
+        return;
+
+    load_string(program, symbol);
+    push_inst_(program, DYN_STR_UNSHARE);
+    push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+}
+
+bool is_nested_index_expr(Expr* expr)
+{
+    return expr->kind == IndexExpr_kind && expr->v.index_expr->x->kind == IndexExpr_kind;
+}
+
+// The containers are shared on assignment, take a copy of the shared one before modifying it
+void unshare_composite(KaosIR* program, Expr* expr)
+{
+    while (expr->kind == IndexExpr_kind)
+        expr = expr->v.index_expr->x;
+    if (expr->kind != Ident_kind)
+        return;
+
+    Symbol* symbol = getSymbol(expr->v.ident->name);
+    if (symbol->reg != 0 || symbol->is_constant)
+        return;
+    if (symbol->type != K_LIST && symbol->type != K_DICT && symbol->type != K_ANY)
+        return;
+
+    load_any(program, symbol);
+    push_inst_r_r(program, DYN_COMP_UNSHARE, R0, R1);
+    push_inst_r_i(program, REF_ALLOCAI, R2, symbol->addr);
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+}
+
+// Shares the container of a variable, returns true if it has to be copied instead
+// since the parameters are references to the containers of the caller
+bool share_composite(KaosIR* program, Expr* expr)
+{
+    Symbol* symbol = getSymbol(expr->v.ident->name);
+    if (symbol->param_of != NULL)
+        return true;
+
+    push_inst_r_r(program, DYN_COMP_SHARE, R0, R1);
+    return false;
+}
+
 void load_list(KaosIR* program, Symbol* symbol)
 {
     i64 addr = symbol->addr;
@@ -2637,6 +2859,12 @@ bool declare_function(Stmt* stmt, File* file, KaosIR* program)
 
     Decl* decl = stmt->v.decl_stmt->decl;
 
+    Spec* result_spec = decl->v.func_decl->type->v.func_type->result;
+    enum Type return_type = compileSpec(program, result_spec);
+    enum Type return_secondary_type = K_ANY;
+    if (result_spec->v.type_spec->sub_type_spec != NULL)
+        return_secondary_type = result_spec->v.type_spec->type;
+
     if (file->aliases->expr_count != 0) {
         bool _return = true;
         for (unsigned long i = 0; i < file->aliases->expr_count; i++) {
@@ -2650,10 +2878,11 @@ bool declare_function(Stmt* stmt, File* file, KaosIR* program)
                 "",
                 file->module_path,
                 file->module_path,
-                K_VOID,
-                K_VOID
+                return_type,
+                return_secondary_type
             );
 
+            function_mode->ast = decl;
             startFunctionScope(function_mode);
             function_mode->optional_parameters_addr = program->size - 1;
             function_mode->addr = label_counter++;
@@ -2675,8 +2904,8 @@ bool declare_function(Stmt* stmt, File* file, KaosIR* program)
         file->module,
         file->module_path,
         file->context,
-        K_VOID,
-        K_VOID
+        return_type,
+        return_secondary_type
     );
 
     if (duplicate_function != NULL) {
@@ -2687,6 +2916,7 @@ bool declare_function(Stmt* stmt, File* file, KaosIR* program)
         return true;
     }
 
+    function_mode->ast = decl;
     startFunctionScope(function_mode);
     function_mode->optional_parameters_addr = program->size - 1;
     function_mode->addr = label_counter++;
@@ -2755,6 +2985,11 @@ void compile_functions(ASTRoot* ast_root, KaosIR* program)
         for (unsigned long j = stmt_list->stmt_count; 0 < j; j--) {
             Stmt* stmt = stmt_list->stmts[j - 1];
             if (stmt->kind == DeclStmt_kind && stmt->v.decl_stmt->decl->kind == FuncDecl_kind) {
+                FuncDecl* func_decl = stmt->v.decl_stmt->decl->v.func_decl;
+                _Function* function = getFunctionByModuleContext(func_decl->name->v.ident->name, file->module_path);
+                if (!function->is_reachable)
+                    continue;
+
                 compileStmt(program, stmt);
             }
         }
@@ -2765,31 +3000,44 @@ void compile_functions(ASTRoot* ast_root, KaosIR* program)
 
 void determine_inline_functions(ASTRoot* ast_root)
 {
+    // The calls made by the statements of the main file are the roots of the call graph
+    _Function* main_function = getFunctionByModuleContext(__KAOS_MAIN_FUNCTION__, ast_root->files[0]->module_path);
+
+    // Measure the functions and weigh the calls made to them in all parsed files
     for (unsigned long i = 0; i < ast_root->file_count; i++) {
         File* file = ast_root->files[i];
         current_file_index = i;
         StmtList* stmt_list = file->stmt_list;
         pushModuleStack(file->module_path, file->module);
 
-        // Foreach function look for other functions' decision blocks for calls
         for (unsigned long j = stmt_list->stmt_count; 0 < j; j--) {
             Stmt* stmt = stmt_list->stmts[j - 1];
             if (stmt->kind == DeclStmt_kind && stmt->v.decl_stmt->decl->kind == FuncDecl_kind) {
-                Decl* decl = stmt->v.decl_stmt->decl;
-                _Function* function = startFunctionNew(decl->v.func_decl->name->v.ident->name);
-                function->should_inline = determine_inline_function(ast_root, function);
+                FuncDecl* func_decl = stmt->v.decl_stmt->decl->v.func_decl;
+                _Function* function = startFunctionNew(func_decl->name->v.ident->name);
+                collect_calls_in_stmt(func_decl->body, function, 1);
+                if (func_decl->decision != NULL) {
+                    ExprList* expr_list = func_decl->decision->v.decision_block->decisions;
+                    for (unsigned long k = 0; k < expr_list->expr_count; k++)
+                        collect_calls_in_expr(expr_list->exprs[k], function, 1);
+                }
                 endFunction();
+
+                // The default values of the optional parameters are compiled along with the declarations
+                SpecList* params = func_decl->type->v.func_type->params->v.field_list_spec->list;
+                for (unsigned long k = 0; k < params->spec_count; k++) {
+                    if (params->specs[k]->kind == OptionalFieldSpec_kind)
+                        collect_calls_in_expr(params->specs[k]->v.optional_field_spec->expr, main_function, 1);
+                }
+            } else if (i == 0) {
+                collect_calls_in_stmt(stmt, main_function, 1);
             }
         }
 
         popModuleStack();
     }
-}
 
-bool determine_inline_function(ASTRoot* ast_root, _Function* function)
-{
-    unsigned long call_counter = 0;
-    // Look for all functions' decision blocks for all the files compiled
+    // Decide whether inlining each of the functions pays off
     for (unsigned long i = 0; i < ast_root->file_count; i++) {
         File* file = ast_root->files[i];
         current_file_index = i;
@@ -2800,72 +3048,218 @@ bool determine_inline_function(ASTRoot* ast_root, _Function* function)
             Stmt* stmt = stmt_list->stmts[j - 1];
             if (stmt->kind == DeclStmt_kind && stmt->v.decl_stmt->decl->kind == FuncDecl_kind) {
                 Decl* decl = stmt->v.decl_stmt->decl;
-                _Function* _function = startFunctionNew(decl->v.func_decl->name->v.ident->name);
-                if (function == _function)
-                    continue;
-                if (decl->v.func_decl->decision != NULL) {
-                    ExprList* expr_list = decl->v.func_decl->decision->v.decision_block->decisions;
-                    for (unsigned long i = expr_list->expr_count; 0 < i; i--) {
-                        Expr* expr = expr_list->exprs[i - 1];
-                        if (does_decision_have_a_call(expr, function)) {
-                            call_counter++;
-                        }
-                    }
-                }
+                _Function* function = startFunctionNew(decl->v.func_decl->name->v.ident->name);
+                function->should_inline = determine_inline_function(function);
                 endFunction();
             }
         }
 
         popModuleStack();
     }
+}
 
-    if (call_counter == 1)
-        return true;
-    else
+bool determine_inline_function(_Function* function)
+{
+    // The later lines of an interactive session might call the function natively
+    if (is_interactive)
+        return false;
+
+    if (function->is_dynamic || function->ast == NULL || function->call_count == 0)
+        return false;
+
+    if (is_recursive_function(function))
         return false;
+
+    // The body is copied to each call site while each call made saves the call ABI
+    unsigned long growth = function->ast_size * (function->call_count - 1);
+    unsigned long benefit = function->call_weight * INLINE_CALL_COST + INLINE_GROWTH_BUDGET;
+    return growth <= benefit;
 }
 
-bool does_decision_have_a_call(Expr* expr, _Function* function)
+bool is_recursive_function(_Function* function)
 {
-    Stmt* stmt = NULL;
-    switch (expr->kind) {
-    case DecisionExpr_kind:
-        stmt = expr->v.decision_expr->outcome;
+    _Function** stack = NULL;
+    unsigned long stack_size = 0;
+    _Function** visited = NULL;
+    unsigned long visited_count = 0;
+    bool is_recursive = false;
+
+    // Walk the call graph starting from the callees and look for a way back
+    stack = realloc(stack, (stack_size + function->callee_count) * sizeof(_Function*));
+    for (unsigned long i = 0; i < function->callee_count; i++)
+        stack[stack_size++] = function->callees[i];
+
+    while (stack_size > 0) {
+        _Function* callee = stack[--stack_size];
+        if (callee == function) {
+            is_recursive = true;
+            break;
+        }
+
+        bool is_visited = false;
+        for (unsigned long i = 0; i < visited_count; i++) {
+            if (visited[i] == callee) {
+                is_visited = true;
+                break;
+            }
+        }
+        if (is_visited)
+            continue;
+
+        visited = realloc(visited, (visited_count + 1) * sizeof(_Function*));
+        visited[visited_count++] = callee;
+
+        stack = realloc(stack, (stack_size + callee->callee_count) * sizeof(_Function*));
+        for (unsigned long i = 0; i < callee->callee_count; i++)
+            stack[stack_size++] = callee->callees[i];
+    }
+
+    free(stack);
+    free(visited);
+    return is_recursive;
+}
+
+void add_callee(_Function* caller, _Function* callee)
+{
+    // The calls through the module contexts lead to the same function
+    if (callee->ref != NULL)
+        callee = callee->ref;
+
+    for (unsigned long i = 0; i < caller->callee_count; i++) {
+        if (caller->callees[i] == callee)
+            return;
+    }
+
+    caller->callees = realloc(caller->callees, (caller->callee_count + 1) * sizeof(_Function*));
+    caller->callees[caller->callee_count++] = callee;
+}
+
+void collect_calls_in_stmt(Stmt* stmt, _Function* caller, unsigned long weight)
+{
+    if (stmt == NULL)
+        return;
+
+    if (caller != NULL)
+        caller->ast_size++;
+
+    switch (stmt->kind) {
+    case AssignStmt_kind:
+        collect_calls_in_expr(stmt->v.assign_stmt->x, caller, weight);
+        collect_calls_in_expr(stmt->v.assign_stmt->y, caller, weight);
         break;
-    case DefaultExpr_kind:
-        stmt = expr->v.default_expr->outcome;
+    case PrintStmt_kind:
+        collect_calls_in_expr(stmt->v.print_stmt->x, caller, weight);
+        break;
+    case EchoStmt_kind:
+        collect_calls_in_expr(stmt->v.echo_stmt->x, caller, weight);
         break;
+    case ReturnStmt_kind:
+        collect_calls_in_expr(stmt->v.return_stmt->x, caller, weight);
+        break;
+    case ExprStmt_kind:
+        collect_calls_in_expr(stmt->v.expr_stmt->x, caller, weight);
+        break;
+    case DeclStmt_kind:
+        collect_calls_in_decl(stmt->v.decl_stmt->decl, caller, weight);
+        break;
+    case ExitStmt_kind:
+        collect_calls_in_expr(stmt->v.exit_stmt->x, caller, weight);
+        break;
+    case BlockStmt_kind: {
+        StmtList* stmt_list = stmt->v.block_stmt->stmt_list;
+        for (unsigned long i = 0; i < stmt_list->stmt_count; i++)
+            collect_calls_in_stmt(stmt_list->stmts[i], caller, weight);
+        break;
+    }
     default:
         break;
     }
+}
 
-    return does_stmt_have_a_call(stmt, function);
+void collect_calls_in_decl(Decl* decl, _Function* caller, unsigned long weight)
+{
+    // The calls in the loop bodies are weighed as if the loops iterate a few times
+    switch (decl->kind) {
+    case VarDecl_kind:
+        collect_calls_in_expr(decl->v.var_decl->expr, caller, weight);
+        break;
+    case TimesDo_kind:
+        collect_calls_in_expr(decl->v.times_do->x, caller, weight);
+        collect_calls_in_expr(decl->v.times_do->call_expr, caller, weight * INLINE_LOOP_WEIGHT);
+        break;
+    case ForeachAsList_kind:
+        collect_calls_in_expr(decl->v.foreach_as_list->x, caller, weight);
+        collect_calls_in_expr(decl->v.foreach_as_list->call_expr, caller, weight * INLINE_LOOP_WEIGHT);
+        break;
+    case ForeachAsDict_kind:
+        collect_calls_in_expr(decl->v.foreach_as_dict->x, caller, weight);
+        collect_calls_in_expr(decl->v.foreach_as_dict->call_expr, caller, weight * INLINE_LOOP_WEIGHT);
+        break;
+    default:
+        break;
+    }
 }
 
-bool does_stmt_have_a_call(Stmt* stmt, _Function* function)
+void collect_calls_in_expr(Expr* expr, _Function* caller, unsigned long weight)
 {
-    if (stmt->kind == ExprStmt_kind && stmt->v.expr_stmt->x->kind == CallExpr_kind) {
-        Expr* expr = stmt->v.expr_stmt->x;
-        _Function* _function = NULL;
-        switch (expr->v.call_expr->fun->kind) {
-        case Ident_kind:
-            _function = getFunction(expr->v.call_expr->fun->v.ident->name, NULL);
-            break;
-        case SelectorExpr_kind:
-            _function = getFunction(
-                expr->v.call_expr->fun->v.selector_expr->sel->v.ident->name,
-                expr->v.call_expr->fun->v.selector_expr->x->v.ident->name
-            );
-            break;
-        default:
-            break;
-        }
+    if (expr == NULL)
+        return;
 
-        if (function == _function)
-            return true;
+    if (caller != NULL)
+        caller->ast_size++;
+
+    switch (expr->kind) {
+    case BinaryExpr_kind:
+        collect_calls_in_expr(expr->v.binary_expr->x, caller, weight);
+        collect_calls_in_expr(expr->v.binary_expr->y, caller, weight);
+        break;
+    case UnaryExpr_kind:
+        collect_calls_in_expr(expr->v.unary_expr->x, caller, weight);
+        break;
+    case ParenExpr_kind:
+        collect_calls_in_expr(expr->v.paren_expr->x, caller, weight);
+        break;
+    case IncDecExpr_kind:
+        collect_calls_in_expr(expr->v.incdec_expr->x, caller, weight);
+        break;
+    case IndexExpr_kind:
+        collect_calls_in_expr(expr->v.index_expr->x, caller, weight);
+        collect_calls_in_expr(expr->v.index_expr->index, caller, weight);
+        break;
+    case CompositeLit_kind: {
+        ExprList* elts = expr->v.composite_lit->elts;
+        for (unsigned long i = 0; i < elts->expr_count; i++)
+            collect_calls_in_expr(elts->exprs[i], caller, weight);
+        break;
     }
+    case KeyValueExpr_kind:
+        collect_calls_in_expr(expr->v.key_value_expr->key, caller, weight);
+        collect_calls_in_expr(expr->v.key_value_expr->value, caller, weight);
+        break;
+    case CallExpr_kind: {
+        _Function* function = get_called_function(expr);
+        if (function != NULL) {
+            function->call_count++;
+            function->call_weight += weight;
+            if (caller != NULL)
+                add_callee(caller, function);
+        }
 
-    return false;
+        ExprList* args = expr->v.call_expr->args;
+        for (unsigned long i = 0; i < args->expr_count; i++)
+            collect_calls_in_expr(args->exprs[i], caller, weight);
+        break;
+    }
+    case DecisionExpr_kind:
+        collect_calls_in_expr(expr->v.decision_expr->bool_expr, caller, weight);
+        collect_calls_in_stmt(expr->v.decision_expr->outcome, caller, weight);
+        break;
+    case DefaultExpr_kind:
+        collect_calls_in_stmt(expr->v.default_expr->outcome, caller, weight);
+        break;
+    default:
+        break;
+    }
 }
 
 void strongly_type(Symbol* symbol_x, Symbol* symbol_y, _Function* function, Expr* expr, enum ValueType value_type)
@@ -2945,3 +3339,1346 @@ void strongly_type_basic_check(unsigned short code, char *str1, char *str2, enum
         break;
     }
 }
+
+void determine_reachable_functions(ASTRoot* ast_root)
+{
+    // Walk the call graph starting from the main file, the rest of the functions are pruned
+    _Function* main_function = getFunctionByModuleContext(__KAOS_MAIN_FUNCTION__, ast_root->files[0]->module_path);
+    mark_reachable_function(main_function);
+
+    for (unsigned long i = 0; i < ast_root->file_count; i++) {
+        File* file = ast_root->files[i];
+        StmtList* stmt_list = file->stmt_list;
+
+        for (unsigned long j = stmt_list->stmt_count; 0 < j; j--) {
+            Stmt* stmt = stmt_list->stmts[j - 1];
+            if (stmt->kind != DeclStmt_kind || stmt->v.decl_stmt->decl->kind != FuncDecl_kind)
+                continue;
+
+            FuncDecl* func_decl = stmt->v.decl_stmt->decl->v.func_decl;
+            _Function* function = getFunctionByModuleContext(func_decl->name->v.ident->name, file->module_path);
+            // The later lines of an interactive session might call any of the functions
+            if (is_interactive)
+                function->is_reachable = true;
+            if (function->is_reachable)
+                continue;
+
+            if (strcmp(file->module, "") == 0) {
+                append_to_array(&pruned_functions, function->name);
+            } else {
+                char* name = malloc(strlen(file->module) + strlen(function->name) + 2);
+                sprintf(name, "%s.%s", file->module, function->name);
+                append_to_array(&pruned_functions, name);
+                free(name);
+            }
+        }
+    }
+}
+
+void mark_reachable_function(_Function* function)
+{
+    if (function->is_reachable)
+        return;
+
+    function->is_reachable = true;
+
+    // The calls through the module contexts lead to the same function
+    if (function->ref != NULL)
+        mark_reachable_function(function->ref);
+
+    for (unsigned long i = 0; i < function->callee_count; i++)
+        mark_reachable_function(function->callees[i]);
+}
+
+void determine_breaking_functions(ASTRoot* ast_root)
+{
+    // Iterate until the functions that call a breaking function are all marked
+    bool is_changed = true;
+    while (is_changed) {
+        is_changed = false;
+        for (unsigned long i = 0; i < ast_root->file_count; i++) {
+            File* file = ast_root->files[i];
+            current_file_index = i;
+            StmtList* stmt_list = file->stmt_list;
+            pushModuleStack(file->module_path, file->module);
+
+            for (unsigned long j = stmt_list->stmt_count; 0 < j; j--) {
+                Stmt* stmt = stmt_list->stmts[j - 1];
+                if (stmt->kind != DeclStmt_kind || stmt->v.decl_stmt->decl->kind != FuncDecl_kind)
+                    continue;
+
+                FuncDecl* func_decl = stmt->v.decl_stmt->decl->v.func_decl;
+                _Function* function = startFunctionNew(func_decl->name->v.ident->name);
+                endFunction();
+                if (function->may_break)
+                    continue;
+
+                bool may_break = does_stmt_break(func_decl->body);
+                if (func_decl->decision != NULL) {
+                    ExprList* expr_list = func_decl->decision->v.decision_block->decisions;
+                    for (unsigned long k = 0; k < expr_list->expr_count; k++)
+                        may_break = may_break || does_expr_break(expr_list->exprs[k]);
+                }
+
+                if (may_break) {
+                    function->may_break = true;
+                    is_changed = true;
+                }
+            }
+
+            popModuleStack();
+        }
+    }
+}
+
+bool does_stmt_break(Stmt* stmt)
+{
+    if (stmt == NULL)
+        return false;
+
+    switch (stmt->kind) {
+    case BreakStmt_kind:
+        return true;
+    case AssignStmt_kind:
+        return does_expr_break(stmt->v.assign_stmt->x) || does_expr_break(stmt->v.assign_stmt->y);
+    case PrintStmt_kind:
+        return does_expr_break(stmt->v.print_stmt->x);
+    case EchoStmt_kind:
+        return does_expr_break(stmt->v.echo_stmt->x);
+    case ReturnStmt_kind:
+        return does_expr_break(stmt->v.return_stmt->x);
+    case ExprStmt_kind:
+        return does_expr_break(stmt->v.expr_stmt->x);
+    case ExitStmt_kind:
+        return does_expr_break(stmt->v.exit_stmt->x);
+    case BlockStmt_kind: {
+        StmtList* stmt_list = stmt->v.block_stmt->stmt_list;
+        for (unsigned long i = 0; i < stmt_list->stmt_count; i++) {
+            if (does_stmt_break(stmt_list->stmts[i]))
+                return true;
+        }
+        return false;
+    }
+    case DeclStmt_kind: {
+        // A loop catches the breaks of the function it calls
+        Decl* decl = stmt->v.decl_stmt->decl;
+        switch (decl->kind) {
+        case VarDecl_kind:
+            return does_expr_break(decl->v.var_decl->expr);
+        case TimesDo_kind:
+            return does_expr_break(decl->v.times_do->x);
+        case ForeachAsList_kind:
+            return does_expr_break(decl->v.foreach_as_list->x);
+        case ForeachAsDict_kind:
+            return does_expr_break(decl->v.foreach_as_dict->x);
+        default:
+            return false;
+        }
+    }
+    default:
+        return false;
+    }
+}
+
+bool does_expr_break(Expr* expr)
+{
+    if (expr == NULL)
+        return false;
+
+    switch (expr->kind) {
+    case BinaryExpr_kind:
+        return does_expr_break(expr->v.binary_expr->x) || does_expr_break(expr->v.binary_expr->y);
+    case UnaryExpr_kind:
+        return does_expr_break(expr->v.unary_expr->x);
+    case ParenExpr_kind:
+        return does_expr_break(expr->v.paren_expr->x);
+    case IndexExpr_kind:
+        return does_expr_break(expr->v.index_expr->x) || does_expr_break(expr->v.index_expr->index);
+    case CompositeLit_kind: {
+        ExprList* elts = expr->v.composite_lit->elts;
+        for (unsigned long i = 0; i < elts->expr_count; i++) {
+            if (does_expr_break(elts->exprs[i]))
+                return true;
+        }
+        return false;
+    }
+    case KeyValueExpr_kind:
+        return does_expr_break(expr->v.key_value_expr->key) || does_expr_break(expr->v.key_value_expr->value);
+    case CallExpr_kind: {
+        _Function* function = get_called_function(expr);
+        if (function != NULL && function->may_break)
+            return true;
+
+        ExprList* args = expr->v.call_expr->args;
+        for (unsigned long i = 0; i < args->expr_count; i++) {
+            if (does_expr_break(args->exprs[i]))
+                return true;
+        }
+        return false;
+    }
+    case DecisionExpr_kind:
+        return does_expr_break(expr->v.decision_expr->bool_expr) || does_stmt_break(expr->v.decision_expr->outcome);
+    case DefaultExpr_kind:
+        return does_stmt_break(expr->v.default_expr->outcome);
+    default:
+        return false;
+    }
+}
+
+void push_loop_context()
+{
+    loop_contexts = realloc(loop_contexts, (loop_context_count + 1) * sizeof(LoopContext));
+    loop_contexts[loop_context_count].break_ops = NULL;
+    loop_contexts[loop_context_count].break_op_count = 0;
+    loop_context_count++;
+}
+
+void pop_loop_context(KaosIR* program)
+{
+    LoopContext* loop_context = &loop_contexts[--loop_context_count];
+    for (i64 i = 0; i < loop_context->break_op_count; i++)
+        push_inst_i(program, PATCH, loop_context->break_ops[i]);
+    free(loop_context->break_ops);
+}
+
+void jump_to_loop_end(KaosIR* program)
+{
+    LoopContext* loop_context = &loop_contexts[loop_context_count - 1];
+    loop_context->break_ops = realloc(loop_context->break_ops, (loop_context->break_op_count + 1) * sizeof(i64));
+    loop_context->break_ops[loop_context->break_op_count++] = op_counter;
+    push_inst_i(program, JMPI_FORWARD, op_counter++);
+}
+
+void compile_break(KaosIR* program)
+{
+    // The loop is compiled into the same function when the breaking function is inlined
+    if (loop_context_count > 0) {
+        jump_to_loop_end(program);
+        return;
+    }
+
+    // Otherwise set the break flag and return, the caller will take it from there
+    push_inst_i(program, DYN_BREAK, 1);
+    push_inst_r(program, RETR, R1);
+}
+
+void compile_break_check(KaosIR* program)
+{
+    i64 _op = op_counter++;
+    push_inst_r(program, DYN_BREAK_HANDLE, R3);
+    push_inst_r_i_i(program, BEQI, R3, 0, _op);
+
+    if (loop_context_count > 0) {
+        push_inst_i(program, DYN_BREAK, 0);
+        jump_to_loop_end(program);
+    } else {
+        push_inst_r(program, RETR, R1);
+    }
+
+    push_inst_i(program, PATCH, _op);
+}
+
+unsigned short compile_inline_site(KaosIR* program, Expr* expr)
+{
+    // A call at the root of an expression has no live registers around it for an inlined body to clobber
+    inline_site = expr;
+    return compileExpr(program, expr);
+}
+
+void bind_inline_parameter(KaosIR* program, Symbol* parameter, Expr* expr, Symbol* symbol_upper, enum ValueType value_type, unsigned long i)
+{
+    // A variable that neither side mutates can be shared instead of copied
+    if (
+        !is_interactive
+        &&
+        symbol_upper != NULL
+        &&
+        !is_in_array(&mutated_names, parameter->name)
+        &&
+        !is_in_array(&mutated_names, expr->v.ident->name)
+    ) {
+        Symbol* symbol_new = createCloneFromSymbol(parameter->name, symbol_upper->type, symbol_upper, symbol_upper->type);
+        symbol_new->addr = symbol_upper->addr;
+        symbol_new->reg = symbol_upper->reg;
+        return;
+    }
+
+    // Anything that isn't known at compile-time is typed at runtime
+    if (value_type == V_VOID || value_type == V_REF)
+        value_type = V_ANY;
+
+    union Value value;
+    value.i = 0;
+    Symbol* symbol = addSymbol(parameter->name, parameter->type, value, value_type);
+    symbol->secondary_type = parameter->secondary_type;
+    symbol->param_of = parameter->param_of;
+
+    switch (value_type) {
+    case V_BOOL:
+    case V_INT:
+    case V_FLOAT:
+        promote_symbol(symbol);
+        push_inst_r_r(program, MOVR, symbol->reg, R0 + (i * 2));
+        if (value_type == V_FLOAT)
+            push_inst_r_r(program, FMOVR, symbol->reg + 1, R1 + (i * 2));
+        else
+            push_inst_r_r(program, MOVR, symbol->reg + 1, R1 + (i * 2));
+        break;
+    default: {
+        if (value_type == V_ANY)
+            symbol->is_dynamic = true;
+
+        i64 addr_reg = promoted_register_counter++;
+        i64 offset_reg = promoted_register_counter++;
+        symbol->addr = stack_counter++;
+        push_inst_i_i(program, ALLOCAI, symbol->addr, 2 * sizeof(long long));
+        push_inst_r_i(program, REF_ALLOCAI, addr_reg, symbol->addr);
+        push_inst_r_r_i(program, STR, addr_reg, R0 + (i * 2), sizeof(long long));
+        push_inst_r_i(program, MOVI, offset_reg, sizeof(long long));
+        push_inst_r_r_r_i(program, STXR, addr_reg, offset_reg, R1 + (i * 2), sizeof(long long));
+        break;
+    }
+    }
+}
+
+void push_inline_context()
+{
+    inline_contexts = realloc(inline_contexts, (inline_context_count + 1) * sizeof(InlineContext));
+    inline_contexts[inline_context_count].return_ops = NULL;
+    inline_contexts[inline_context_count].return_op_count = 0;
+    inline_context_count++;
+}
+
+void pop_inline_context(KaosIR* program)
+{
+    InlineContext* inline_context = &inline_contexts[--inline_context_count];
+    for (i64 i = 0; i < inline_context->return_op_count; i++)
+        push_inst_i(program, PATCH, inline_context->return_ops[i]);
+    free(inline_context->return_ops);
+}
+
+void compile_return(KaosIR* program)
+{
+    if (inline_context_count == 0) {
+        push_inst_r(program, RETR, R1);
+        return;
+    }
+
+    // Returning from an inlined function is a jump to the end of its body
+    InlineContext* inline_context = &inline_contexts[inline_context_count - 1];
+    inline_context->return_ops = realloc(inline_context->return_ops, (inline_context->return_op_count + 1) * sizeof(i64));
+    inline_context->return_ops[inline_context->return_op_count++] = op_counter;
+    push_inst_i(program, JMPI_FORWARD, op_counter++);
+}
+
+void compile_outcome(KaosIR* program, Stmt* stmt)
+{
+    if (stmt->kind == ExprStmt_kind && is_tail_call(stmt->v.expr_stmt->x)) {
+        compile_tail_call(program, stmt->v.expr_stmt->x);
+        return;
+    }
+
+    compileStmt(program, stmt);
+}
+
+bool is_tail_call(Expr* expr)
+{
+    // Only the calls to the function being compiled can reuse its frame,
+    // a jump can't cross into the prolog of another native function
+    if (compiling_function == NULL || expr->kind != CallExpr_kind)
+        return false;
+
+    _Function* function = get_called_function(expr);
+    return function == compiling_function
+        && !function->is_dynamic
+        && expr->v.call_expr->args->expr_count == function->parameter_count;
+}
+
+void compile_tail_call(KaosIR* program, Expr* expr)
+{
+    _Function* function = compiling_function;
+    ExprList* expr_list = expr->v.call_expr->args;
+
+    for (unsigned long i = 0; i < expr_list->expr_count; i++)
+        unshare_composite(program, expr_list->exprs[i]);
+
+    // Evaluate all of the arguments first since they may read the parameters
+    Expr* unshare_composite_backup = unshare_composite_expr;
+    for (unsigned long i = 0; i < expr_list->expr_count; i++) {
+        register_offset = i * 2;
+        unshare_composite_expr = expr_list->exprs[i];
+        compileExpr(program, expr_list->exprs[i]);
+        unshare_composite_expr = unshare_composite_backup;
+        register_offset = 0;
+    }
+
+    i64 addr_reg = promoted_register_counter++;
+    i64 offset_reg = promoted_register_counter++;
+    for (unsigned long i = 0; i < expr_list->expr_count; i++) {
+        Symbol* parameter = function->parameters[i];
+
+        if (parameter->type == K_BOOL || parameter->type == K_NUMBER) {
+            push_inst_r_r(program, MOVR, parameter->reg, R0 + (i * 2));
+            push_inst_r_r(program, MOVR, parameter->reg + 1, R1 + (i * 2));
+            continue;
+        }
+
+        push_inst_r_i(program, REF_ALLOCAI, addr_reg, parameter->addr);
+        push_inst_r_r_i(program, STR, addr_reg, R0 + (i * 2), sizeof(long long));
+        push_inst_r_i(program, MOVI, offset_reg, sizeof(long long));
+        push_inst_r_r_r_i(program, STXR, addr_reg, offset_reg, R1 + (i * 2), sizeof(long long));
+    }
+
+    push_inst_i(program, JMPI, function->body_addr);
+}
+
+_Function* get_called_function(Expr* expr)
+{
+    _Function* function = NULL;
+    if (get_list_builtin(expr) != NULL)
+        return function;
+
+    switch (expr->v.call_expr->fun->kind) {
+    case Ident_kind:
+        function = getFunction(expr->v.call_expr->fun->v.ident->name, NULL);
+        break;
+    case SelectorExpr_kind:
+        function = getFunction(
+            expr->v.call_expr->fun->v.selector_expr->sel->v.ident->name,
+            expr->v.call_expr->fun->v.selector_expr->x->v.ident->name
+        );
+        break;
+    default:
+        break;
+    }
+    return function;
+}
+
+enum ValueType infer_list_element_type(ExprList* expr_list)
+{
+    if (expr_list->expr_count == 0)
+        return V_ANY;
+
+    enum ValueType element_type = infer_expr_type(expr_list->exprs[0]);
+    if (!CPU_LIST_IS_UNBOXED_TYPE(element_type))
+        return V_ANY;
+
+    for (unsigned long i = 1; i < expr_list->expr_count; i++) {
+        if (infer_expr_type(expr_list->exprs[i]) != element_type)
+            return V_ANY;
+    }
+    return element_type;
+}
+
+void compile_list_element_load(KaosIR* program, enum IRRegister list_reg, enum IRRegister index_reg)
+{
+    // The raw values of an unboxed list are loaded directly, the refs go through the runtime
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENT_TYPE_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, R0, list_reg, R2, sizeof(long long));
+    i64 boxed_op = op_counter++;
+    push_inst_r_i_i(program, BEQI, R0, V_ANY, boxed_op);
+
+    compile_list_element_offset(program, list_reg, index_reg);
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENTS_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, R2, list_reg, R2, sizeof(long long));
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+
+    // The raw value is boxed into a fresh cell, since the callers expect the element's ref in R2
+    i64 cell_addr = stack_counter++;
+    push_inst_i_i(program, ALLOCAI, cell_addr, 2 * sizeof(long long));
+    push_inst_r_i(program, REF_ALLOCAI, R2, cell_addr);
+    push_inst_r_r_i(program, STR, R2, R0, sizeof(long long));
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+    i64 end_op = op_counter++;
+    push_inst_i(program, JMPI_FORWARD, end_op);
+
+    push_inst_i(program, PATCH, boxed_op);
+    push_inst_r_i(program, MOVI, R0, V_LIST);
+    push_inst_r_r_r(program, DYN_COMP_ACCESS, list_reg, R0, index_reg);
+    push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+    push_inst_i(program, PATCH, end_op);
+}
+
+void compile_dict_element_load(KaosIR* program, enum IRRegister dict_reg, enum IRRegister key_reg)
+{
+    push_inst_r_i(program, MOVI, R0, V_DICT);
+    push_inst_r_r_r(program, DYN_COMP_ACCESS, dict_reg, R0, key_reg);
+    push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+}
+
+void compile_list_elements_load(KaosIR* program, enum IRRegister list_reg, enum IRRegister element_type_reg, enum IRRegister elements_reg)
+{
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENT_TYPE_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, element_type_reg, list_reg, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENTS_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, elements_reg, list_reg, R2, sizeof(long long));
+}
+
+void compile_foreach_element_load(KaosIR* program, enum IRRegister element_type_reg, enum IRRegister elements_reg, enum IRRegister index_reg)
+{
+    // The loop index never goes negative, so both the raw values and the refs are read straight from the elements
+    push_inst_r_r_i(program, MULI, R3, index_reg, sizeof(i64));
+    push_inst_r_r(program, MOVR, R2, elements_reg);
+    push_inst_r_r(program, MOVR, R0, element_type_reg);
+    i64 boxed_op = op_counter++;
+    push_inst_r_i_i(program, BEQI, R0, V_ANY, boxed_op);
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+    i64 end_op = op_counter++;
+    push_inst_i(program, JMPI_FORWARD, end_op);
+
+    push_inst_i(program, PATCH, boxed_op);
+    push_inst_r_r_r_i(program, LDXR, R2, R2, R3, sizeof(long long));
+    push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+    push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+    push_inst_i(program, PATCH, end_op);
+}
+
+/*
+ * A literal can't be reached from anywhere else and a variable that is never mutated
+ * keeps its elements, since the other names that share it copy it before a write.
+ * A variable that escapes might still be mutated in place through a parameter,
+ * whose mutations are recorded under the parameter's name.
+ */
+bool is_invariant_composite(Expr* expr, Expr* call_expr)
+{
+    switch (expr->kind) {
+    case CompositeLit_kind:
+        return true;
+    case Ident_kind: {
+        char* name = expr->v.ident->name;
+        if (is_in_array(&mutated_names, name) || is_in_array(&escaped_names, name))
+            return false;
+
+        if (call_expr == NULL || call_expr->kind != CallExpr_kind)
+            return true;
+
+        ExprList* args = call_expr->v.call_expr->args;
+        for (unsigned long i = 0; i < args->expr_count; i++) {
+            if (args->exprs[i]->kind == Ident_kind && strcmp(args->exprs[i]->v.ident->name, name) == 0)
+                return false;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void compile_list_element_store(KaosIR* program)
+{
+    // A value of the same type as the unboxed list is stored directly,
+    // anything else is left to the runtime which may turn the list into a list of refs
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENT_TYPE_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, R3, R12, R2, sizeof(long long));
+    i64 unboxed_op = op_counter++;
+    push_inst_r_r_i(program, BEQR, R3, R0, unboxed_op);
+    push_inst_(program, DYN_LIST_INDEX_UPDATE);
+    i64 end_op = op_counter++;
+    push_inst_i(program, JMPI_FORWARD, end_op);
+
+    push_inst_i(program, PATCH, unboxed_op);
+    compile_list_element_offset(program, R12, R13);
+    push_inst_r_i(program, MOVI, R2, CPU_LIST_ELEMENTS_OFFSET);
+    push_inst_r_r_r_i(program, LDXR, R2, R12, R2, sizeof(long long));
+    i64 float_op = op_counter++;
+    push_inst_r_i_i(program, BEQI, R0, V_FLOAT, float_op);
+    push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+    i64 int_end_op = op_counter++;
+    push_inst_i(program, JMPI_FORWARD, int_end_op);
+    push_inst_i(program, PATCH, float_op);
+    push_inst_r_r_r_i(program, FSTXR, R2, R3, R1, sizeof(double));
+    push_inst_i(program, PATCH, int_end_op);
+    push_inst_i(program, PATCH, end_op);
+}
+
+void compile_list_element_offset(KaosIR* program, enum IRRegister list_reg, enum IRRegister index_reg)
+{
+    // R3 = (index < 0 ? len + index : index) * sizeof(i64)
+    push_inst_r_r(program, MOVR, R3, index_reg);
+    push_inst_r_i(program, MOVI, R2, 0);
+    push_inst_r_r_r(program, LTR, R2, R3, R2);
+    i64 positive_op = op_counter++;
+    push_inst_r_i_i(program, BEQI, R2, 0, positive_op);
+    push_inst_r_r_i(program, LDR, R2, list_reg, sizeof(size_t));
+    push_inst_r_r_r(program, ADDR, R3, R3, R2);
+    push_inst_i(program, PATCH, positive_op);
+    push_inst_r_r_i(program, MULI, R3, R3, sizeof(i64));
+}
+
+ListBuiltin* get_list_builtin(Expr* expr)
+{
+    if (expr->v.call_expr->fun->kind != Ident_kind)
+        return NULL;
+
+    char* name = expr->v.call_expr->fun->v.ident->name;
+    for (size_t i = 0; i < sizeof(list_builtins) / sizeof(list_builtins[0]); i++) {
+        // A function defined by the program shadows the built-in
+        if (strcmp(list_builtins[i].name, name) == 0 && findFunction(name, NULL) == NULL)
+            return &list_builtins[i];
+    }
+    return NULL;
+}
+
+void compile_list_builtin(KaosIR* program, Expr* expr, ListBuiltin* builtin)
+{
+    ExprList* args = expr->v.call_expr->args;
+    if (args->expr_count != builtin->arg_count)
+        throw_error(E_INCORRECT_FUNCTION_ARGUMENT_COUNT, builtin->name);
+
+    // The arguments are held in the reverse order, the list is the first one in the source
+    Expr* list_expr = args->exprs[args->expr_count - 1];
+    enum ValueType list_type = infer_expr_type(list_expr);
+    if (list_type != V_LIST && list_type != V_ANY)
+        throw_error(E_NOT_A_LIST, list_expr->kind == Ident_kind ? list_expr->v.ident->name : builtin->name);
+
+    // The list and the index are kept in the stack while the element is being compiled
+    i64 operands_addr = stack_counter++;
+    push_inst_i_i(program, ALLOCAI, operands_addr, 2 * sizeof(long long));
+    Expr* unshare_composite_backup = unshare_composite_expr;
+    if (builtin->op_code != DYN_LIST_KERNEL) {
+        unshare_composite(program, list_expr);
+        unshare_composite_expr = list_expr;
+    }
+    compileExpr(program, list_expr);
+    unshare_composite_expr = unshare_composite_backup;
+    push_inst_r_i(program, REF_ALLOCAI, R2, operands_addr);
+    push_inst_r_r_i(program, STR, R2, R1, sizeof(long long));
+    if (builtin->op_code == DYN_LIST_INSERT) {
+        compileExpr(program, args->exprs[args->expr_count - 2]);
+        push_inst_r_i(program, REF_ALLOCAI, R2, operands_addr);
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, STXR, R2, R3, R1, sizeof(long long));
+    }
+
+    // The reductions take nothing but the list
+    if (builtin->arg_count > 1)
+        compileExpr(program, args->exprs[0]);
+    push_inst_r_i(program, REF_ALLOCAI, R2, operands_addr);
+    push_inst_r_r_i(program, LDR, R12, R2, sizeof(long long));
+    if (builtin->op_code == DYN_LIST_INSERT) {
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, LDXR, R13, R2, R3, sizeof(long long));
+    }
+
+    if (builtin->op_code == DYN_LIST_KERNEL) {
+        // Evaluates to the result cell of the kernel
+        push_inst_i(program, DYN_LIST_KERNEL, builtin->kernel);
+        push_inst_r_r_i(program, LDR, R0, R2, sizeof(long long));
+        push_inst_r_i(program, MOVI, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, LDXR, R1, R2, R3, sizeof(long long));
+        push_inst_r_r_r_i(program, FLDXR, R1, R2, R3, sizeof(double));
+        return;
+    }
+    push_inst_(program, builtin->op_code);
+
+    // Evaluates to the list itself
+    push_inst_r_i(program, REF_ALLOCAI, R2, operands_addr);
+    push_inst_r_r_i(program, LDR, R1, R2, sizeof(long long));
+    push_inst_r_i(program, MOVI, R0, V_LIST);
+}
+
+enum ValueType get_function_value_type(_Function* function)
+{
+    // The body of an inlined function decides the type at runtime
+    if (function->should_inline)
+        return V_ANY;
+
+    switch (function->type) {
+    case K_BOOL:
+        return V_BOOL;
+    case K_NUMBER:
+        return V_INT;
+    default:
+        return V_ANY;
+    }
+}
+
+enum ValueType infer_expr_type(Expr* expr)
+{
+    switch (expr->kind) {
+    case BasicLit_kind:
+        return expr->v.basic_lit->value_type;
+    case Ident_kind: {
+        Symbol* symbol = findSymbol(expr->v.ident->name);
+        if (symbol == NULL || symbol->type == K_ANY)
+            return V_ANY;
+
+        // The value type of a parameter is a placeholder, only its declared type is known
+        if (symbol->param_of != NULL && symbol->type == K_LIST)
+            return V_LIST;
+        if (symbol->param_of != NULL && symbol->type == K_DICT)
+            return V_DICT;
+
+        switch (symbol->value_type) {
+        case V_BOOL:
+        case V_INT:
+        case V_FLOAT:
+        case V_STRING:
+        case V_LIST:
+        case V_DICT:
+            return symbol->value_type;
+        default:
+            return V_ANY;
+        }
+    }
+    case ParenExpr_kind:
+        return infer_expr_type(expr->v.paren_expr->x);
+    case UnaryExpr_kind: {
+        enum ValueType type = infer_expr_type(expr->v.unary_expr->x);
+        switch (expr->v.unary_expr->op) {
+        case ADD_tok:
+        case SUB_tok:
+            if (type == V_INT || type == V_FLOAT)
+                return type;
+            return V_ANY;
+        case NOT_tok:
+            return V_BOOL;
+        case TILDE_tok:
+            return type == V_INT ? V_INT : V_ANY;
+        default:
+            return V_ANY;
+        }
+    }
+    case BinaryExpr_kind: {
+        enum ValueType type_x = infer_expr_type(expr->v.binary_expr->x);
+        enum ValueType type_y = infer_expr_type(expr->v.binary_expr->y);
+        switch (expr->v.binary_expr->op) {
+        case ADD_tok:
+        case SUB_tok:
+        case MUL_tok:
+        case QUO_tok:
+            if (type_x == V_INT && type_y == V_INT)
+                return V_INT;
+            if (is_numeric_value_type(type_x) && is_numeric_value_type(type_y))
+                return V_FLOAT;
+            return V_ANY;
+        case EQL_tok:
+        case NEQ_tok:
+        case GTR_tok:
+        case LSS_tok:
+        case GEQ_tok:
+        case LEQ_tok:
+        case LAND_tok:
+        case LOR_tok:
+            return V_BOOL;
+        default:
+            return V_ANY;
+        }
+    }
+    case CallExpr_kind:
+        if (get_list_builtin(expr) != NULL)
+            return get_list_builtin(expr)->result_type;
+        return get_function_value_type(get_called_function(expr));
+    default:
+        return V_ANY;
+    }
+}
+
+bool is_numeric_value_type(enum ValueType value_type)
+{
+    return value_type == V_INT || value_type == V_FLOAT;
+}
+
+bool compile_static_binary_expr(KaosIR* program, enum Token op, enum ValueType type_x, enum ValueType type_y)
+{
+    enum IROpCode op_code;
+    enum IROpCode float_op_code;
+    bool is_comparison = false;
+
+    switch (op) {
+    case ADD_tok:
+        op_code = ADDR;
+        float_op_code = FADDR;
+        break;
+    case SUB_tok:
+        op_code = SUBR;
+        float_op_code = FSUBR;
+        break;
+    case MUL_tok:
+        op_code = MULR;
+        float_op_code = FMULR;
+        break;
+    case QUO_tok:
+        op_code = DIVR;
+        float_op_code = FDIVR;
+        break;
+    case EQL_tok:
+        op_code = EQR;
+        float_op_code = FEQR;
+        is_comparison = true;
+        break;
+    case NEQ_tok:
+        op_code = NER;
+        float_op_code = FNER;
+        is_comparison = true;
+        break;
+    case GTR_tok:
+        op_code = GTR;
+        float_op_code = FGTR;
+        is_comparison = true;
+        break;
+    case LSS_tok:
+        op_code = LTR;
+        float_op_code = FLTR;
+        is_comparison = true;
+        break;
+    case GEQ_tok:
+        op_code = GER;
+        float_op_code = FGER;
+        is_comparison = true;
+        break;
+    case LEQ_tok:
+        op_code = LER;
+        float_op_code = FLER;
+        is_comparison = true;
+        break;
+    default:
+        return false;
+    }
+
+    // Booleans are plain integers, so they compare like one
+    if (is_comparison) {
+        if (type_x == V_BOOL)
+            type_x = V_INT;
+        if (type_y == V_BOOL)
+            type_y = V_INT;
+    }
+
+    if (!is_numeric_value_type(type_x) || !is_numeric_value_type(type_y))
+        return false;
+
+    if (type_x == V_INT && type_y == V_INT) {
+        push_inst_r_r_r(program, op_code, R1, R1, R5);
+        push_inst_r_i(program, MOVI, R0, is_comparison ? V_BOOL : V_INT);
+        return true;
+    }
+
+    // Mixed operands are promoted to float
+    if (type_x == V_INT)
+        push_inst_r_r(program, EXTR, R1, R1);
+    if (type_y == V_INT)
+        push_inst_r_r(program, EXTR, R2, R5);
+
+    push_inst_r_r_r(program, float_op_code, R1, R1, R2);
+    push_inst_r_i(program, MOVI, R0, is_comparison ? V_BOOL : V_FLOAT);
+    return true;
+}
+
+void collect_mutated_names(ASTRoot* ast_root)
+{
+    for (unsigned long i = 0; i < ast_root->file_count; i++) {
+        StmtList* stmt_list = ast_root->files[i]->stmt_list;
+        for (unsigned long j = 0; j < stmt_list->stmt_count; j++)
+            collect_mutated_names_in_stmt(stmt_list->stmts[j]);
+    }
+}
+
+void collect_mutated_names_in_stmt(Stmt* stmt)
+{
+    if (stmt == NULL)
+        return;
+
+    switch (stmt->kind) {
+    case AssignStmt_kind:
+        mark_mutated_name(stmt->v.assign_stmt->x);
+        collect_mutated_names_in_expr(stmt->v.assign_stmt->y, true);
+        break;
+    case PrintStmt_kind:
+        collect_mutated_names_in_expr(stmt->v.print_stmt->x, false);
+        break;
+    case EchoStmt_kind:
+        collect_mutated_names_in_expr(stmt->v.echo_stmt->x, false);
+        break;
+    case ReturnStmt_kind:
+        collect_mutated_names_in_expr(stmt->v.return_stmt->x, true);
+        break;
+    case ExprStmt_kind:
+        collect_mutated_names_in_expr(stmt->v.expr_stmt->x, false);
+        break;
+    case DeclStmt_kind:
+        collect_mutated_names_in_decl(stmt->v.decl_stmt->decl);
+        break;
+    case DelStmt_kind:
+        mark_mutated_name(stmt->v.del_stmt->ident);
+        break;
+    case ExitStmt_kind:
+        collect_mutated_names_in_expr(stmt->v.exit_stmt->x, false);
+        break;
+    case BlockStmt_kind: {
+        StmtList* stmt_list = stmt->v.block_stmt->stmt_list;
+        for (unsigned long i = 0; i < stmt_list->stmt_count; i++)
+            collect_mutated_names_in_stmt(stmt_list->stmts[i]);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void collect_mutated_names_in_decl(Decl* decl)
+{
+    switch (decl->kind) {
+    case VarDecl_kind:
+        collect_mutated_names_in_expr(decl->v.var_decl->expr, true);
+        break;
+    case TimesDo_kind:
+        collect_mutated_names_in_expr(decl->v.times_do->x, false);
+        collect_mutated_names_in_expr(decl->v.times_do->call_expr, false);
+        break;
+    case ForeachAsList_kind:
+        collect_mutated_names_in_expr(decl->v.foreach_as_list->x, true);
+        collect_mutated_names_in_expr(decl->v.foreach_as_list->call_expr, false);
+        break;
+    case ForeachAsDict_kind:
+        collect_mutated_names_in_expr(decl->v.foreach_as_dict->x, true);
+        collect_mutated_names_in_expr(decl->v.foreach_as_dict->call_expr, false);
+        break;
+    case FuncDecl_kind: {
+        collect_mutated_names_in_stmt(decl->v.func_decl->body);
+        Spec* decision = decl->v.func_decl->decision;
+        if (decision == NULL)
+            break;
+
+        ExprList* decisions = decision->v.decision_block->decisions;
+        for (unsigned long i = 0; i < decisions->expr_count; i++)
+            collect_mutated_names_in_expr(decisions->exprs[i], false);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/*
+ * An escaping variable is one that its value might be referenced by another variable,
+ * a composite or a function. Strings are passed by reference so an escaping string
+ * can be modified through the other name.
+ */
+void collect_mutated_names_in_expr(Expr* expr, bool is_escaping)
+{
+    if (expr == NULL)
+        return;
+
+    switch (expr->kind) {
+    case Ident_kind:
+        if (is_escaping)
+            append_to_array(&escaped_names, expr->v.ident->name);
+        break;
+    case BinaryExpr_kind:
+        collect_mutated_names_in_expr(expr->v.binary_expr->x, false);
+        collect_mutated_names_in_expr(expr->v.binary_expr->y, false);
+        break;
+    case UnaryExpr_kind:
+        collect_mutated_names_in_expr(expr->v.unary_expr->x, false);
+        break;
+    case ParenExpr_kind:
+        collect_mutated_names_in_expr(expr->v.paren_expr->x, is_escaping);
+        break;
+    case IncDecExpr_kind:
+        mark_mutated_name(expr->v.incdec_expr->x);
+        break;
+    case IndexExpr_kind:
+        collect_mutated_names_in_expr(expr->v.index_expr->x, is_escaping);
+        collect_mutated_names_in_expr(expr->v.index_expr->index, false);
+        break;
+    case CompositeLit_kind: {
+        ExprList* elts = expr->v.composite_lit->elts;
+        for (unsigned long i = 0; i < elts->expr_count; i++)
+            collect_mutated_names_in_expr(elts->exprs[i], true);
+        break;
+    }
+    case KeyValueExpr_kind:
+        collect_mutated_names_in_expr(expr->v.key_value_expr->key, true);
+        collect_mutated_names_in_expr(expr->v.key_value_expr->value, true);
+        break;
+    case CallExpr_kind: {
+        ExprList* args = expr->v.call_expr->args;
+        // The list built-ins that grow a list modify their first argument
+        ListBuiltin* builtin = get_list_builtin(expr);
+        if (builtin != NULL && builtin->op_code != DYN_LIST_KERNEL && args->expr_count > 0)
+            mark_mutated_name(args->exprs[args->expr_count - 1]);
+        for (unsigned long i = 0; i < args->expr_count; i++)
+            collect_mutated_names_in_expr(args->exprs[i], true);
+        break;
+    }
+    case DecisionExpr_kind:
+        collect_mutated_names_in_expr(expr->v.decision_expr->bool_expr, false);
+        collect_mutated_names_in_stmt(expr->v.decision_expr->outcome);
+        break;
+    case DefaultExpr_kind:
+        collect_mutated_names_in_stmt(expr->v.default_expr->outcome);
+        break;
+    default:
+        break;
+    }
+}
+
+void mark_mutated_name(Expr* expr)
+{
+    switch (expr->kind) {
+    case Ident_kind:
+        append_to_array(&mutated_names, expr->v.ident->name);
+        break;
+    case IndexExpr_kind:
+        mark_mutated_name(expr->v.index_expr->x);
+        collect_mutated_names_in_expr(expr->v.index_expr->index, false);
+        break;
+    default:
+        collect_mutated_names_in_expr(expr, true);
+        break;
+    }
+}
+
+bool can_be_constant(char *name, enum ValueType value_type)
+{
+    // The later lines of an interactive session are not known in advance
+    if (is_interactive)
+        return false;
+
+    if (is_in_array(&mutated_names, name))
+        return false;
+
+    if (value_type == V_STRING && is_in_array(&escaped_names, name))
+        return false;
+
+    return true;
+}
+
+/*
+ * `s = s + a + b` appends to the string of `s` in-place if no other name can reference it,
+ * the appended operands must not reference `s` either.
+ */
+bool is_string_append(Expr* x, Expr* y)
+{
+    if (is_interactive || x->kind != Ident_kind)
+        return false;
+
+    char *name = x->v.ident->name;
+    Symbol* symbol = findSymbol(name);
+    if (symbol == NULL || symbol->type != K_STRING || symbol->value_type != V_STRING)
+        return false;
+
+    if (is_in_array(&escaped_names, name))
+        return false;
+
+    Expr* expr = y;
+    while (expr->kind == BinaryExpr_kind && expr->v.binary_expr->op == ADD_tok) {
+        Expr* piece = expr->v.binary_expr->y;
+        if (infer_expr_type(piece) != V_STRING || does_expr_use_name(piece, name))
+            return false;
+        expr = expr->v.binary_expr->x;
+    }
+
+    return expr != y && expr->kind == Ident_kind && strcmp(expr->v.ident->name, name) == 0;
+}
+
+bool is_string_append_site(Expr* expr)
+{
+    for (Expr* site = string_append_expr; site != NULL && site->kind == BinaryExpr_kind; site = site->v.binary_expr->x) {
+        if (site == expr)
+            return true;
+    }
+    return false;
+}
+
+bool is_unshare_composite_site(Expr* expr)
+{
+    for (Expr* site = unshare_composite_expr; site != NULL && site->kind == IndexExpr_kind; site = site->v.index_expr->x) {
+        if (site == expr)
+            return true;
+    }
+    return false;
+}
+
+bool does_expr_use_name(Expr* expr, char *name)
+{
+    if (expr == NULL)
+        return false;
+
+    switch (expr->kind) {
+    case Ident_kind:
+        return strcmp(expr->v.ident->name, name) == 0;
+    case BinaryExpr_kind:
+        return does_expr_use_name(expr->v.binary_expr->x, name) || does_expr_use_name(expr->v.binary_expr->y, name);
+    case UnaryExpr_kind:
+        return does_expr_use_name(expr->v.unary_expr->x, name);
+    case ParenExpr_kind:
+        return does_expr_use_name(expr->v.paren_expr->x, name);
+    case IncDecExpr_kind:
+        return does_expr_use_name(expr->v.incdec_expr->x, name);
+    case IndexExpr_kind:
+        return does_expr_use_name(expr->v.index_expr->x, name) || does_expr_use_name(expr->v.index_expr->index, name);
+    case CompositeLit_kind: {
+        ExprList* elts = expr->v.composite_lit->elts;
+        for (unsigned long i = 0; i < elts->expr_count; i++) {
+            if (does_expr_use_name(elts->exprs[i], name))
+                return true;
+        }
+        return false;
+    }
+    case KeyValueExpr_kind:
+        return does_expr_use_name(expr->v.key_value_expr->key, name) || does_expr_use_name(expr->v.key_value_expr->value, name);
+    case CallExpr_kind: {
+        ExprList* args = expr->v.call_expr->args;
+        for (unsigned long i = 0; i < args->expr_count; i++) {
+            if (does_expr_use_name(args->exprs[i], name))
+                return true;
+        }
+        return false;
+    }
+    default:
+        return false;
+    }
+}
+
+bool fold_constant_expr(Expr* expr, BasicLit* result)
+{
+    switch (expr->kind) {
+    case BasicLit_kind:
+        *result = *expr->v.basic_lit;
+        if (result->value_type == V_STRING) {
+            result->value.s = malloc(1 + strlen(expr->v.basic_lit->value.s));
+            strcpy(result->value.s, expr->v.basic_lit->value.s);
+        }
+        return true;
+    case Ident_kind: {
+        Symbol* symbol = findSymbol(expr->v.ident->name);
+        if (symbol == NULL || !symbol->is_constant)
+            return false;
+
+        result->value_type = symbol->value_type;
+        result->value = symbol->value;
+        if (result->value_type == V_STRING) {
+            result->value.s = malloc(1 + strlen(symbol->value.s));
+            strcpy(result->value.s, symbol->value.s);
+        }
+        return true;
+    }
+    case ParenExpr_kind:
+        return fold_constant_expr(expr->v.paren_expr->x, result);
+    case UnaryExpr_kind: {
+        BasicLit x;
+        if (!fold_constant_expr(expr->v.unary_expr->x, &x))
+            return false;
+
+        bool is_folded = fold_unary_expr(expr->v.unary_expr->op, &x, result);
+        free_basic_lit_value(&x);
+        return is_folded;
+    }
+    case BinaryExpr_kind: {
+        BasicLit x;
+        BasicLit y;
+        if (!fold_constant_expr(expr->v.binary_expr->x, &x))
+            return false;
+        if (!fold_constant_expr(expr->v.binary_expr->y, &y)) {
+            free_basic_lit_value(&x);
+            return false;
+        }
+
+        bool is_folded = fold_binary_expr(expr->v.binary_expr->op, &x, &y, result);
+        free_basic_lit_value(&x);
+        free_basic_lit_value(&y);
+        return is_folded;
+    }
+    default:
+        return false;
+    }
+}
+
+/*
+ * The folding mirrors the semantics of the instructions that would be emitted otherwise.
+ * The operations that would trap or are decided by the hardware are left to the runtime.
+ */
+bool fold_unary_expr(enum Token op, BasicLit* x, BasicLit* result)
+{
+    switch (op) {
+    case ADD_tok:
+        if (!is_numeric_value_type(x->value_type))
+            return false;
+        *result = *x;
+        return true;
+    case SUB_tok:
+        result->value_type = x->value_type;
+        if (x->value_type == V_INT)
+            result->value.i = (long long)(0 - (unsigned long long)x->value.i);
+        else if (x->value_type == V_FLOAT)
+            result->value.f = -x->value.f;
+        else
+            return false;
+        return true;
+    case NOT_tok:
+        result->value_type = V_BOOL;
+        if (x->value_type == V_BOOL)
+            result->value.b = !x->value.b;
+        else if (x->value_type == V_INT)
+            result->value.b = !(x->value.i > 0);
+        else
+            return false;
+        return true;
+    case TILDE_tok:
+        if (x->value_type != V_INT)
+            return false;
+        result->value_type = V_INT;
+        result->value.i = ~x->value.i;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool fold_binary_expr(enum Token op, BasicLit* x, BasicLit* y, BasicLit* result)
+{
+    if (op == ADD_tok && x->value_type == V_STRING && y->value_type == V_STRING) {
+        result->value_type = V_STRING;
+        result->value.s = malloc(1 + strlen(x->value.s) + strlen(y->value.s));
+        strcpy(result->value.s, x->value.s);
+        strcat(result->value.s, y->value.s);
+        return true;
+    }
+
+    // Booleans are plain integers for the comparison and logic operations
+    bool is_bool_allowed = false;
+    switch (op) {
+    case EQL_tok:
+    case NEQ_tok:
+    case GTR_tok:
+    case LSS_tok:
+    case GEQ_tok:
+    case LEQ_tok:
+    case LAND_tok:
+    case LOR_tok:
+        is_bool_allowed = true;
+        break;
+    default:
+        break;
+    }
+
+    enum ValueType type_x = x->value_type;
+    enum ValueType type_y = y->value_type;
+    long long i_x = type_x == V_BOOL ? x->value.b : x->value.i;
+    long long i_y = type_y == V_BOOL ? y->value.b : y->value.i;
+    if (is_bool_allowed && type_x == V_BOOL)
+        type_x = V_INT;
+    if (is_bool_allowed && type_y == V_BOOL)
+        type_y = V_INT;
+
+    if (!is_numeric_value_type(type_x) || !is_numeric_value_type(type_y))
+        return false;
+
+    if (type_x == V_INT && type_y == V_INT) {
+        result->value_type = V_INT;
+        switch (op) {
+        case ADD_tok:
+            result->value.i = (long long)((unsigned long long)i_x + (unsigned long long)i_y);
+            return true;
+        case SUB_tok:
+            result->value.i = (long long)((unsigned long long)i_x - (unsigned long long)i_y);
+            return true;
+        case MUL_tok:
+            result->value.i = (long long)((unsigned long long)i_x * (unsigned long long)i_y);
+            return true;
+        case QUO_tok:
+        case REM_tok:
+            if (i_y == 0 || (i_x == LLONG_MIN && i_y == -1))
+                return false;
+            result->value.i = op == QUO_tok ? i_x / i_y : i_x % i_y;
+            return true;
+        case AND_tok:
+            result->value.i = i_x & i_y;
+            return true;
+        case OR_tok:
+            result->value.i = i_x | i_y;
+            return true;
+        case XOR_tok:
+            result->value.i = i_x ^ i_y;
+            return true;
+        case SHL_tok:
+        case SHR_tok:
+            if (i_y < 0 || i_y >= 64)
+                return false;
+            result->value.i = op == SHL_tok ? (long long)((unsigned long long)i_x << i_y) : i_x >> i_y;
+            return true;
+        default:
+            break;
+        }
+    }
+
+    result->value_type = V_BOOL;
+    switch (op) {
+    case LAND_tok:
+        if (type_x != V_INT || type_y != V_INT)
+            return false;
+        result->value.b = i_x > 0 && i_y > 0;
+        return true;
+    case LOR_tok:
+        if (type_x != V_INT || type_y != V_INT)
+            return false;
+        result->value.b = i_x > 0 || i_y > 0;
+        return true;
+    default:
+        break;
+    }
+
+    // Mixed operands are promoted to float
+    double f_x = type_x == V_FLOAT ? x->value.f : (double)i_x;
+    double f_y = type_y == V_FLOAT ? y->value.f : (double)i_y;
+    bool is_float = type_x == V_FLOAT || type_y == V_FLOAT;
+
+    switch (op) {
+    case EQL_tok:
+        result->value.b = is_float ? f_x == f_y : i_x == i_y;
+        return true;
+    case NEQ_tok:
+        result->value.b = is_float ? f_x != f_y : i_x != i_y;
+        return true;
+    case GTR_tok:
+        result->value.b = is_float ? f_x > f_y : i_x > i_y;
+        return true;
+    case LSS_tok:
+        result->value.b = is_float ? f_x < f_y : i_x < i_y;
+        return true;
+    case GEQ_tok:
+        result->value.b = is_float ? f_x >= f_y : i_x >= i_y;
+        return true;
+    case LEQ_tok:
+        result->value.b = is_float ? f_x <= f_y : i_x <= i_y;
+        return true;
+    default:
+        break;
+    }
+
+    result->value_type = V_FLOAT;
+    switch (op) {
+    case ADD_tok:
+        result->value.f = f_x + f_y;
+        return true;
+    case SUB_tok:
+        result->value.f = f_x - f_y;
+        return true;
+    case MUL_tok:
+        result->value.f = f_x * f_y;
+        return true;
+    case QUO_tok:
+        result->value.f = f_x / f_y;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void free_basic_lit_value(BasicLit* basic_lit)
+{
+    if (basic_lit->value_type == V_STRING)
+        free(basic_lit->value.s);
+}
@@ -24,9 +24,34 @@
 #define KAOS_COMPILER_H
 
 #include "../vm/cpu.h"
+#include "../vm/simd.h"
 #include "../ast/ast.h"
 #include "../interpreter/module_new.h"
 
+typedef struct LoopContext {
+    i64* break_ops;
+    i64 break_op_count;
+} LoopContext;
+
+typedef struct InlineContext {
+    i64* return_ops;
+    i64 return_op_count;
+} InlineContext;
+
+// The built-in functions that grow a list in place or run a vectorized kernel over it
+typedef struct ListBuiltin {
+    char* name;
+    enum IROpCode op_code;
+    unsigned long arg_count;
+    i64 kernel;
+    enum ValueType result_type;
+} ListBuiltin;
+
+// The cost model of the inliner, the sizes are counted in AST nodes
+#define INLINE_CALL_COST 8
+#define INLINE_GROWTH_BUDGET 32
+#define INLINE_LOOP_WEIGHT 10
+
 KaosIR* compile(ASTRoot* ast_root);
 void initCallJumps();
 void fillCallJumps(KaosIR* program);
@@ -39,12 +64,15 @@ void declareSpecList(KaosIR* program, SpecList* spec_list);
 void compileSpecList(KaosIR* program, SpecList* spec_list);
 unsigned short declareSpec(KaosIR* program, Spec* spec);
 unsigned short compileSpec(KaosIR* program, Spec* spec);
+void compile_basic_lit(KaosIR* program, BasicLit* basic_lit);
 
+enum IRRegister offset_register(enum IRRegister reg);
 void push_inst_(KaosIR* program, enum IROpCode op_code);
 void push_inst_i(KaosIR* program, enum IROpCode op_code, i64 i);
 void push_inst_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg);
 void push_inst_i_i(KaosIR* program, enum IROpCode op_code, i64 i1, i64 i2);
 void push_inst_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, i64 i);
+void push_inst_r_s(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, byte* addr);
 void push_inst_r_f(KaosIR* program, enum IROpCode op_code, enum IRRegister reg, f64 f);
 void push_inst_r_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2);
 void push_inst_r_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, i64 i);
@@ -53,10 +81,11 @@ void push_inst_r_r_f(KaosIR* program, enum IROpCode op_code, enum IRRegister reg
 void push_inst_r_r_r(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, enum IRRegister reg3);
 void push_inst_r_r_r_i(KaosIR* program, enum IROpCode op_code, enum IRRegister reg1, enum IRRegister reg2, enum IRRegister reg3, i64 i);
 
-void pushProgram(KaosIR* program, KaosInst* el);
+KaosInst* pushProgram(KaosIR* program, enum IROpCode op_code);
 KaosInst* popProgram(KaosIR* program);
 void freeProgram(KaosIR* program);
 KaosIR* initProgram();
+byte* push_string_data(KaosIR* program, char *s);
 void shift_registers(KaosIR* program);
 
 Symbol* store_bool(KaosIR* program, char *name, bool is_any);
@@ -67,10 +96,18 @@ Symbol* store_list(KaosIR* program, char *name, size_t len, bool is_dynamic);
 Symbol* store_dict(KaosIR* program, char *name, size_t len, bool is_dynamic);
 Symbol* store_any(KaosIR* program, char *name);
 
+void promote_symbol(Symbol* symbol);
+void store_type(KaosIR* program, Symbol* symbol, enum IRRegister addr_reg);
+void store_value(KaosIR* program, Symbol* symbol, enum IRRegister addr_reg, enum ValueType value_type);
+
 void load_bool(KaosIR* program, Symbol* symbol);
 void load_int(KaosIR* program, Symbol* symbol);
 void load_float(KaosIR* program, Symbol* symbol);
 void load_string(KaosIR* program, Symbol* symbol);
+void unshare_string(KaosIR* program, Expr* expr);
+bool is_nested_index_expr(Expr* expr);
+void unshare_composite(KaosIR* program, Expr* expr);
+bool share_composite(KaosIR* program, Expr* expr);
 void load_list(KaosIR* program, Symbol* symbol);
 void load_dict(KaosIR* program, Symbol* symbol);
 void load_any(KaosIR* program, Symbol* symbol);
@@ -79,10 +116,63 @@ char* compile_module_selector(Expr* module_selector);
 bool declare_function(Stmt* stmt, File* file, KaosIR* program);
 void declare_functions(ASTRoot* ast_root, KaosIR* program);
 void compile_functions(ASTRoot* ast_root, KaosIR* program);
+void determine_reachable_functions(ASTRoot* ast_root);
+void mark_reachable_function(_Function* function);
 void determine_inline_functions(ASTRoot* ast_root);
-bool determine_inline_function(ASTRoot* ast_root, _Function* function);
-bool does_decision_have_a_call(Expr* expr, _Function* function);
-bool does_stmt_have_a_call(Stmt* stmt, _Function* function);
+bool determine_inline_function(_Function* function);
+bool is_recursive_function(_Function* function);
+void add_callee(_Function* caller, _Function* callee);
+void collect_calls_in_stmt(Stmt* stmt, _Function* caller, unsigned long weight);
+void collect_calls_in_decl(Decl* decl, _Function* caller, unsigned long weight);
+void collect_calls_in_expr(Expr* expr, _Function* caller, unsigned long weight);
+unsigned short compile_inline_site(KaosIR* program, Expr* expr);
+void bind_inline_parameter(KaosIR* program, Symbol* parameter, Expr* expr, Symbol* symbol_upper, enum ValueType value_type, unsigned long i);
+void push_inline_context();
+void pop_inline_context(KaosIR* program);
+void compile_return(KaosIR* program);
+
+void determine_breaking_functions(ASTRoot* ast_root);
+bool does_stmt_break(Stmt* stmt);
+bool does_expr_break(Expr* expr);
+void push_loop_context();
+void pop_loop_context(KaosIR* program);
+void jump_to_loop_end(KaosIR* program);
+void compile_break(KaosIR* program);
+void compile_break_check(KaosIR* program);
+void compile_outcome(KaosIR* program, Stmt* stmt);
+bool is_tail_call(Expr* expr);
+void compile_tail_call(KaosIR* program, Expr* expr);
+
+_Function* get_called_function(Expr* expr);
+enum ValueType infer_list_element_type(ExprList* expr_list);
+void compile_list_element_load(KaosIR* program, enum IRRegister list_reg, enum IRRegister index_reg);
+void compile_dict_element_load(KaosIR* program, enum IRRegister dict_reg, enum IRRegister key_reg);
+void compile_list_elements_load(KaosIR* program, enum IRRegister list_reg, enum IRRegister element_type_reg, enum IRRegister elements_reg);
+void compile_foreach_element_load(KaosIR* program, enum IRRegister element_type_reg, enum IRRegister elements_reg, enum IRRegister index_reg);
+bool is_invariant_composite(Expr* expr, Expr* call_expr);
+void compile_list_element_store(KaosIR* program);
+void compile_list_element_offset(KaosIR* program, enum IRRegister list_reg, enum IRRegister index_reg);
+ListBuiltin* get_list_builtin(Expr* expr);
+void compile_list_builtin(KaosIR* program, Expr* expr, ListBuiltin* builtin);
+enum ValueType get_function_value_type(_Function* function);
+enum ValueType infer_expr_type(Expr* expr);
+bool is_numeric_value_type(enum ValueType value_type);
+bool compile_static_binary_expr(KaosIR* program, enum Token op, enum ValueType type_x, enum ValueType type_y);
+
+void collect_mutated_names(ASTRoot* ast_root);
+void collect_mutated_names_in_stmt(Stmt* stmt);
+void collect_mutated_names_in_decl(Decl* decl);
+void collect_mutated_names_in_expr(Expr* expr, bool is_escaping);
+void mark_mutated_name(Expr* expr);
+bool can_be_constant(char *name, enum ValueType value_type);
+bool is_string_append(Expr* x, Expr* y);
+bool is_string_append_site(Expr* expr);
+bool is_unshare_composite_site(Expr* expr);
+bool does_expr_use_name(Expr* expr, char *name);
+bool fold_constant_expr(Expr* expr, BasicLit* result);
+bool fold_unary_expr(enum Token op, BasicLit* x, BasicLit* result);
+bool fold_binary_expr(enum Token op, BasicLit* x, BasicLit* y, BasicLit* result);
+void free_basic_lit_value(BasicLit* basic_lit);
 
 void strongly_type(Symbol* symbol_x, Symbol* symbol_y, _Function* function, Expr* expr, enum ValueType value_type);
 void strongly_type_basic_check(unsigned short code, char *str1, char *str2, enum Type type, enum ValueType value_type);
@@ -66,29 +66,29 @@ void emitBytecode(cpu *c)
     // >>> Function Declaration <<<
     // declare_label
     case DECLARE_LABEL:
-        sprintf(str_inst, "%s %lld", "DECLARE_LABEL", c->inst->op1->value.i);
+        sprintf(str_inst, "%s %lld", "DECLARE_LABEL", c->inst->op1.value.i);
         break;
     // prolog
     case PROLOG:
-        sprintf(str_inst, "%s label: %lld", "PROLOG", c->inst->op1->value.i);
+        sprintf(str_inst, "%s label: %lld", "PROLOG", c->inst->op1.value.i);
         break;
     case MAIN_PROLOG:
         sprintf(str_inst, "%s", "MAIN_PROLOG");
         break;
     // declare_arg
     case DECLARE_ARG:
-        sprintf(str_inst, "%s type: %s size: %lld", "DECLARE_ARG", getArgTypeName(c->inst->op1->value.i), c->inst->op2->value.i);
+        sprintf(str_inst, "%s type: %s size: %lld", "DECLARE_ARG", getArgTypeName(c->inst->op1.value.i), c->inst->op2.value.i);
         break;
     // getarg
     case GETARG:
-        sprintf(str_inst, "%s R(%d) %lld", "GETARG", c->inst->op1->reg, c->inst->op2->value.i);
+        sprintf(str_inst, "%s R(%d) %lld", "GETARG", c->inst->op1.reg, c->inst->op2.value.i);
         break;
     // ret
     case RETR:
-        sprintf(str_inst, "%s R(%d)", "RETR", c->inst->op1->reg);
+        sprintf(str_inst, "%s R(%d)", "RETR", c->inst->op1.reg);
         break;
     case RETI:
-        sprintf(str_inst, "%s %lld", "RETI", c->inst->op1->value.i);
+        sprintf(str_inst, "%s %lld", "RETI", c->inst->op1.value.i);
         break;
     // >>> Function Calls <<<
     // prepare
@@ -97,209 +97,268 @@ void emitBytecode(cpu *c)
         break;
     // putarg
     case PUTARGR:
-        sprintf(str_inst, "%s R(%d)", "PUTARGR", c->inst->op1->reg);
+        sprintf(str_inst, "%s R(%d)", "PUTARGR", c->inst->op1.reg);
         break;
     case PUTARGI:
-        sprintf(str_inst, "%s %lld", "PUTARGI", c->inst->op1->value.i);
+        sprintf(str_inst, "%s %lld", "PUTARGI", c->inst->op1.value.i);
         break;
     // retval
     case RETVAL:
-        sprintf(str_inst, "%s R(%d)", "RETVAL", c->inst->op1->reg);
+        sprintf(str_inst, "%s R(%d)", "RETVAL", c->inst->op1.reg);
         break;
     // call
     case CALLR:
-        sprintf(str_inst, "%s R(%d)", "CALLR", c->inst->op1->reg);
+        sprintf(str_inst, "%s R(%d)", "CALLR", c->inst->op1.reg);
         break;
     case CALL:
-        sprintf(str_inst, "%s label: %lld op: %lld", "CALL", c->inst->op1->value.i, c->inst->op2->value.i);
+        sprintf(str_inst, "%s label: %lld op: %lld", "CALL", c->inst->op1.value.i, c->inst->op2.value.i);
         break;
     // >>> Transfer Operations <<<
     // mov
     case MOVR:
-        sprintf(str_inst, "%s R(%d) R(%d)", "MOVR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) R(%d)", "MOVR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     case MOVI:
-        sprintf(str_inst, "%s R(%d) %lld", "MOVI", c->inst->op1->reg, c->inst->op2->value.i);
+        if (c->inst->op2.value_type == IR_STRING)
+            sprintf(str_inst, "%s R(%d) string: %zu chars", "MOVI", c->inst->op1.reg, *(size_t*)c->inst->op2.value.s);
+        else
+            sprintf(str_inst, "%s R(%d) %lld", "MOVI", c->inst->op1.reg, c->inst->op2.value.i);
         break;
     // fmov
     case FMOV:
-        sprintf(str_inst, "%s FR(%d) %lf", "FMOV", c->inst->op1->reg, c->inst->op2->value.f);
+        sprintf(str_inst, "%s FR(%d) %lf", "FMOV", c->inst->op1.reg, c->inst->op2.value.f);
         break;
     case FMOVR:
-        sprintf(str_inst, "%s FR(%d) FR(%d)", "FMOVR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s FR(%d) FR(%d)", "FMOVR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // alloc
     case ALLOCAI:
-        sprintf(str_inst, "%s addr: %lld space: %lld", "ALLOCAI", c->inst->op1->value.i, c->inst->op2->value.i);
+        sprintf(str_inst, "%s addr: %lld space: %lld", "ALLOCAI", c->inst->op1.value.i, c->inst->op2.value.i);
         break;
     case REF_ALLOCAI:
-        sprintf(str_inst, "%s R(%d) addr: %lld", "REF_ALLOCAI", c->inst->op1->reg, c->inst->op2->value.i);
+        sprintf(str_inst, "%s R(%d) addr: %lld", "REF_ALLOCAI", c->inst->op1.reg, c->inst->op2.value.i);
         break;
     // >>> Load Operations <<<
     // ldr
     case LDR:
-        sprintf(str_inst, "%s R(%d) R(%d) size: %lld", "LDR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) size: %lld", "LDR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     case LDXR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d) size: %lld", "LDXR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg, c->inst->op4->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d) size: %lld", "LDXR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg, c->inst->op4.value.i);
+        break;
+    case LDXI:
+        sprintf(str_inst, "%s R(%d) R(%d) %lld size: %lld", "LDXI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i, c->inst->op4.value.i);
         break;
     // >>> Store Operations <<<
     // str
     case STR:
-        sprintf(str_inst, "%s R(%d) R(%d) size: %lld", "STR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) size: %lld", "STR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     case STXR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d) size: %lld", "STXR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg, c->inst->op4->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d) size: %lld", "STXR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg, c->inst->op4.value.i);
+        break;
+    case STXI:
+        sprintf(str_inst, "%s R(%d) %lld R(%d) size: %lld", "STXI", c->inst->op1.reg, c->inst->op2.value.i, c->inst->op3.reg, c->inst->op4.value.i);
         break;
     // fstr
     case FSTR:
-        sprintf(str_inst, "%s R(%d) FR(%d) size: %lld", "FSTR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) FR(%d) size: %lld", "FSTR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     case FSTXR:
-        sprintf(str_inst, "%s R(%d) R(%d) FR(%d) size: %lld", "FSTXR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg, c->inst->op4->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) FR(%d) size: %lld", "FSTXR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg, c->inst->op4.value.i);
+        break;
+    case FSTXI:
+        sprintf(str_inst, "%s R(%d) %lld FR(%d) size: %lld", "FSTXI", c->inst->op1.reg, c->inst->op2.value.i, c->inst->op3.reg, c->inst->op4.value.i);
         break;
     // fldr
     case FLDR:
-        sprintf(str_inst, "%s FR(%d) R(%d) size: %lld", "FLDR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s FR(%d) R(%d) size: %lld", "FLDR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     case FLDXR:
-        sprintf(str_inst, "%s FR(%d) R(%d) R(%d) size: %lld", "FLDXR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg, c->inst->op4->value.i);
+        sprintf(str_inst, "%s FR(%d) R(%d) R(%d) size: %lld", "FLDXR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg, c->inst->op4.value.i);
+        break;
+    case FLDXI:
+        sprintf(str_inst, "%s FR(%d) R(%d) %lld size: %lld", "FLDXI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i, c->inst->op4.value.i);
         break;
     // >>> Binary Arithmetic Operations <<<
     // add
     case ADDR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ADDR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ADDR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case ADDI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ADDI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ADDI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // sub
     case SUBR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "SUBR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "SUBR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case SUBI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "SUBI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "SUBI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // mul
     case MULR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "MULR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "MULR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case MULI:
-        sprintf(str_inst, "%s R(%d) R(%d) imm: %lld", "MULI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) imm: %lld", "MULI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // div
     case DIVR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "DIVR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "DIVR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case DIVI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "DIVI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "DIVI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // mod
     case MODR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "MODR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "MODR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case MODI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "MODI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "MODI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // Binary Logic
     // and
     case ANDR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ANDR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ANDR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case ANDI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ANDI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ANDI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // or
     case ORR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ORR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "ORR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case ORI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ORI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "ORI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // xor
     case XORR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "XORR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "XORR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case XORI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "XORI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "XORI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // Binary Shift
     // lsh
     case LSHR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LSHR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LSHR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case LSHI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "LSHI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "LSHI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
         break;
     // rsh
     case RSHR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "RSHR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "RSHR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     case RSHI:
-        sprintf(str_inst, "%s R(%d) R(%d) %lld", "RSHI", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) R(%d) %lld", "RSHI", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.value.i);
+        break;
+    // >>> Binary Floating-point Arithmetic Operations <<<
+    // fadd
+    case FADDR:
+        sprintf(str_inst, "%s FR(%d) FR(%d) FR(%d)", "FADDR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fsub
+    case FSUBR:
+        sprintf(str_inst, "%s FR(%d) FR(%d) FR(%d)", "FSUBR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fmul
+    case FMULR:
+        sprintf(str_inst, "%s FR(%d) FR(%d) FR(%d)", "FMULR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fdiv
+    case FDIVR:
+        sprintf(str_inst, "%s FR(%d) FR(%d) FR(%d)", "FDIVR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // >>> Unary Arithmetic Operations <<<
     // negr
     case NEGR:
-        sprintf(str_inst, "%s R(%d) R(%d)", "NEGR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) R(%d)", "NEGR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // fnegr
     case FNEGR:
-        sprintf(str_inst, "%s FR(%d) FR(%d)", "FNEGR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s FR(%d) FR(%d)", "FNEGR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // notr
     case NOTR:
-        sprintf(str_inst, "%s R(%d) R(%d)", "NOTR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) R(%d)", "NOTR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // >>> Compare Instructions <<<
     // eqr
     case EQR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "EQR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "EQR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // ner
     case NER:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "NER", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "NER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // gtr
     case GTR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "GTR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "GTR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // ltr
     case LTR:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LTR", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LTR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // ger
     case GER:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "GER", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "GER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // ler
     case LER:
-        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LER", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "LER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // feqr
+    case FEQR:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FEQR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fner
+    case FNER:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FNER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fgtr
+    case FGTR:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FGTR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fltr
+    case FLTR:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FLTR", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fger
+    case FGER:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FGER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // fler
+    case FLER:
+        sprintf(str_inst, "%s R(%d) FR(%d) FR(%d)", "FLER", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // >>> Conversions <<<
     // extr
     case EXTR:
-        sprintf(str_inst, "%s FR(%d) R(%d)", "EXTR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s FR(%d) R(%d)", "EXTR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // truncr
     case TRUNCR:
-        sprintf(str_inst, "%s R(%d) FR(%d)", "TRUNCR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) FR(%d)", "TRUNCR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     // >>> Branch Operations & Jumps <<<
     // beq
     case BEQR:
-        sprintf(str_inst, "%s R(%d) R(%d)", "BEQR", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) R(%d)", "BEQR", c->inst->op1.reg, c->inst->op2.reg);
         break;
     case BEQI:
-        sprintf(str_inst, "%s R(%d) %lld op: %lld", "BEQI", c->inst->op1->reg, c->inst->op2->value.i, c->inst->op3->value.i);
+        sprintf(str_inst, "%s R(%d) %lld op: %lld", "BEQI", c->inst->op1.reg, c->inst->op2.value.i, c->inst->op3.value.i);
         break;
     // jmpi
     case JMPI:
-        sprintf(str_inst, "%s op: %lld", "JMPI", c->inst->op1->value.i);
+        sprintf(str_inst, "%s op: %lld", "JMPI", c->inst->op1.value.i);
+        break;
+    case JMPI_FORWARD:
+        sprintf(str_inst, "%s op: %lld", "JMPI_FORWARD", c->inst->op1.value.i);
         break;
     // patch
     case PATCH:
-        sprintf(str_inst, "%s op: %lld", "PATCH", c->inst->op1->value.i);
+        sprintf(str_inst, "%s op: %lld", "PATCH", c->inst->op1.value.i);
         break;
     // >>> Non-Atomic Instructions <<<
     // Dynamic Instructions (prefixed with `DYN_`)
@@ -377,7 +436,7 @@ void emitBytecode(cpu *c)
         sprintf(str_inst, "%s", "DYN_STR_INDEX_ACCESS");
         break;
     case DYN_COMP_ACCESS:
-        sprintf(str_inst, "%s addr: R(%d) R(%d) R(%d)", "DYN_COMP_ACCESS", c->inst->op1->reg, c->inst->op2->reg, c->inst->op3->reg);
+        sprintf(str_inst, "%s addr: R(%d) R(%d) R(%d)", "DYN_COMP_ACCESS", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
         break;
     // Dynamic Index Update
     case DYN_LIST_INDEX_UPDATE:
@@ -397,16 +456,46 @@ void emitBytecode(cpu *c)
     case DYN_NEW_DICT:
         sprintf(str_inst, "%s", "DYN_NEW_DICT");
         break;
+    // Dynamic Grow List
+    case DYN_LIST_APPEND:
+        sprintf(str_inst, "%s", "DYN_LIST_APPEND");
+        break;
+    case DYN_LIST_EXTEND:
+        sprintf(str_inst, "%s", "DYN_LIST_EXTEND");
+        break;
+    case DYN_LIST_INSERT:
+        sprintf(str_inst, "%s", "DYN_LIST_INSERT");
+        break;
+    // Dynamic Vectorized List Kernels
+    case DYN_LIST_KERNEL:
+        sprintf(str_inst, "%s %lld", "DYN_LIST_KERNEL", c->inst->op1.value.i);
+        break;
     // Dynamic Composite Helpers
     case DYN_GET_COMP_SIZE:
-        sprintf(str_inst, "%s R(%d) R(%d)", "DYN_GET_COMP_SIZE", c->inst->op1->reg, c->inst->op2->reg);
+        sprintf(str_inst, "%s R(%d) R(%d)", "DYN_GET_COMP_SIZE", c->inst->op1.reg, c->inst->op2.reg);
+        break;
+    case DYN_COMP_SHARE:
+        sprintf(str_inst, "%s R(%d) R(%d)", "DYN_COMP_SHARE", c->inst->op1.reg, c->inst->op2.reg);
+        break;
+    case DYN_COMP_UNSHARE:
+        sprintf(str_inst, "%s R(%d) R(%d)", "DYN_COMP_UNSHARE", c->inst->op1.reg, c->inst->op2.reg);
+        break;
+    case DYN_COMP_UNSHARE_ELEMENT:
+        sprintf(str_inst, "%s R(%d) R(%d) R(%d)", "DYN_COMP_UNSHARE_ELEMENT", c->inst->op1.reg, c->inst->op2.reg, c->inst->op3.reg);
+        break;
+    // Dynamic String Helpers
+    case DYN_STR_UNSHARE:
+        sprintf(str_inst, "%s", "DYN_STR_UNSHARE");
+        break;
+    case DYN_STR_APPEND:
+        sprintf(str_inst, "%s", "DYN_STR_APPEND");
         break;
     // Dynamic Loop Break
     case DYN_BREAK:
-        sprintf(str_inst, "%s", "DYN_BREAK");
+        sprintf(str_inst, "%s %lld", "DYN_BREAK", c->inst->op1.value.i);
         break;
     case DYN_BREAK_HANDLE:
-        sprintf(str_inst, "%s", "DYN_BREAK_HANDLE");
+        sprintf(str_inst, "%s R(%d)", "DYN_BREAK_HANDLE", c->inst->op1.reg);
         break;
     // Debug
     case DEBUG:
@@ -0,0 +1,505 @@
+/*
+ * Description: Peephole optimizer of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "compiler_optimizer.h"
+#include "compiler_ssa.h"
+
+// The passes are run in this order, append a new one to plug it in
+KaosIRPass optimizer_passes[] = {
+    forward_known_values,
+    eliminate_dead_moves,
+};
+
+// The passes over the SSA form, they run after the peephole passes on the optimization level 2
+KaosIRPass ssa_passes[] = {
+    number_values,
+    eliminate_dead_code,
+};
+
+i64 optimize(KaosIR* program, unsigned short level)
+{
+    if (program->size == 0 || level == 0)
+        return 0;
+
+    bool* removed = calloc(program->size, sizeof(bool));
+    i64 removed_count = 0;
+
+    for (size_t i = 0; i < sizeof(optimizer_passes) / sizeof(optimizer_passes[0]); i++)
+        removed_count += optimizer_passes[i](program, removed);
+
+    if (level > 1) {
+        for (size_t i = 0; i < sizeof(ssa_passes) / sizeof(ssa_passes[0]); i++)
+            removed_count += ssa_passes[i](program, removed);
+    }
+
+    compact_program(program, removed);
+    free(removed);
+
+    return removed_count;
+}
+
+void forget_registers(KnownRegister* known)
+{
+    for (i64 i = 0; i < IR_NUM_REGISTERS; i++)
+        known[i].kind = KNOWN_NONE;
+}
+
+bool is_known(KnownRegister* known, enum IRRegister reg, enum KnownRegisterKind kind, i64 value)
+{
+    if (reg >= IR_NUM_REGISTERS)
+        return false;
+    return known[reg].kind == kind && known[reg].value == value;
+}
+
+i64 forget_memory(KnownMemory* memory, i64 memory_size, i64 slot, i64 offset, i64 size)
+{
+    i64 j = 0;
+    for (i64 i = 0; i < memory_size; i++) {
+        bool overlaps = memory[i].slot == slot
+            && memory[i].offset < offset + size
+            && offset < memory[i].offset + memory[i].size;
+        if (!overlaps)
+            memory[j++] = memory[i];
+    }
+    return j;
+}
+
+i64 forget_memory_of_registers(KnownMemory* memory, i64 memory_size, u64 defs)
+{
+    i64 j = 0;
+    for (i64 i = 0; i < memory_size; i++) {
+        u64 bit = memory[i].is_float ? IR_FREG_BIT(memory[i].reg) : IR_REG_BIT(memory[i].reg);
+        if (!(defs & bit))
+            memory[j++] = memory[i];
+    }
+    return j;
+}
+
+/*
+ * Walks the basic blocks forward while keeping track of the registers that hold a known
+ * immediate or a known stack slot address and the registers that were stored into the stack slots.
+ * Removes the repeated `MOVI` and `REF_ALLOCAI` instructions, folds the known indexes into
+ * immediate offsets and forwards the stored registers into the loads from the same cell.
+ */
+i64 forward_known_values(KaosIR* program, bool* removed)
+{
+    i64 removed_count = 0;
+    KnownRegister known[IR_NUM_REGISTERS];
+    KnownMemory memory[IR_MEMORY_TABLE_SIZE];
+    i64 memory_size = 0;
+    forget_registers(known);
+
+    for (i64 i = 0; i < program->size; i++) {
+        if (removed[i])
+            continue;
+
+        KaosInst* inst = &program->arr[i];
+
+        switch (inst->op_code) {
+        case MOVI:
+            if (is_known(known, inst->op1.reg, KNOWN_IMM, inst->op2.value.i)) {
+                removed[i] = true;
+                removed_count++;
+                continue;
+            }
+            break;
+        case REF_ALLOCAI:
+            if (is_known(known, inst->op1.reg, KNOWN_SLOT, inst->op2.value.i)) {
+                removed[i] = true;
+                removed_count++;
+                continue;
+            }
+            break;
+        case LDXR:
+        case FLDXR:
+            if (inst->op3.reg < IR_NUM_REGISTERS && known[inst->op3.reg].kind == KNOWN_IMM) {
+                inst->op_code = inst->op_code == LDXR ? LDXI : FLDXI;
+                inst->op3.type = IR_VAL;
+                inst->op3.value_type = IR_INT;
+                inst->op3.value.i = known[inst->op3.reg].value;
+            }
+            break;
+        case STXR:
+        case FSTXR:
+            if (inst->op2.reg < IR_NUM_REGISTERS && known[inst->op2.reg].kind == KNOWN_IMM) {
+                inst->op_code = inst->op_code == STXR ? STXI : FSTXI;
+                inst->op2.type = IR_VAL;
+                inst->op2.value_type = IR_INT;
+                inst->op2.value.i = known[inst->op2.reg].value;
+            }
+            break;
+        default:
+            break;
+        }
+
+        // Forward the register that was stored into the same cell
+        switch (inst->op_code) {
+        case LDR:
+        case LDXI:
+        case FLDR:
+        case FLDXI: {
+            if (inst->op2.reg >= IR_NUM_REGISTERS || known[inst->op2.reg].kind != KNOWN_SLOT)
+                break;
+
+            bool is_float = inst->op_code == FLDR || inst->op_code == FLDXI;
+            bool is_indexed = inst->op_code == LDXI || inst->op_code == FLDXI;
+            i64 slot = known[inst->op2.reg].value;
+            i64 offset = is_indexed ? inst->op3.value.i : 0;
+            i64 size = is_indexed ? inst->op4.value.i : inst->op3.value.i;
+
+            for (i64 j = 0; j < memory_size; j++) {
+                if (
+                    memory[j].slot == slot &&
+                    memory[j].offset == offset &&
+                    memory[j].size == size &&
+                    memory[j].is_float == is_float
+                ) {
+                    inst->op_code = is_float ? FMOVR : MOVR;
+                    inst->op2.reg = memory[j].reg;
+                    break;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if ((inst->op_code == MOVR || inst->op_code == FMOVR) && inst->op1.reg == inst->op2.reg) {
+            removed[i] = true;
+            removed_count++;
+            continue;
+        }
+
+        KaosInstEffects effects = get_inst_effects(inst);
+
+        if (effects.is_barrier || effects.clobbers_registers) {
+            forget_registers(known);
+            memory_size = 0;
+            continue;
+        }
+
+        for (i64 reg = 0; reg < IR_NUM_REGISTERS; reg++) {
+            if (effects.defs & IR_REG_BIT(reg))
+                known[reg].kind = KNOWN_NONE;
+        }
+        memory_size = forget_memory_of_registers(memory, memory_size, effects.defs);
+
+        switch (inst->op_code) {
+        case MOVI:
+            if (inst->op1.reg < IR_NUM_REGISTERS) {
+                known[inst->op1.reg].kind = KNOWN_IMM;
+                known[inst->op1.reg].value = inst->op2.value.i;
+            }
+            break;
+        case REF_ALLOCAI:
+            if (inst->op1.reg < IR_NUM_REGISTERS) {
+                known[inst->op1.reg].kind = KNOWN_SLOT;
+                known[inst->op1.reg].value = inst->op2.value.i;
+            }
+            break;
+        case MOVR:
+            if (inst->op1.reg < IR_NUM_REGISTERS && inst->op2.reg < IR_NUM_REGISTERS)
+                known[inst->op1.reg] = known[inst->op2.reg];
+            break;
+        case STR:
+        case STXI:
+        case FSTR:
+        case FSTXI: {
+            bool is_float = inst->op_code == FSTR || inst->op_code == FSTXI;
+            bool is_indexed = inst->op_code == STXI || inst->op_code == FSTXI;
+            KaosOp* value_op = is_indexed ? &inst->op3 : &inst->op2;
+            i64 offset = is_indexed ? inst->op2.value.i : 0;
+            i64 size = is_indexed ? inst->op4.value.i : inst->op3.value.i;
+
+            if (inst->op1.reg >= IR_NUM_REGISTERS || known[inst->op1.reg].kind != KNOWN_SLOT) {
+                memory_size = 0;
+                break;
+            }
+
+            i64 slot = known[inst->op1.reg].value;
+            memory_size = forget_memory(memory, memory_size, slot, offset, size);
+            if (value_op->reg < IR_NUM_REGISTERS && memory_size < IR_MEMORY_TABLE_SIZE) {
+                memory[memory_size].slot = slot;
+                memory[memory_size].offset = offset;
+                memory[memory_size].size = size;
+                memory[memory_size].is_float = is_float;
+                memory[memory_size].reg = value_op->reg;
+                memory_size++;
+            }
+            break;
+        }
+        default:
+            if (effects.clobbers_memory)
+                memory_size = 0;
+            break;
+        }
+    }
+
+    return removed_count;
+}
+
+/*
+ * Walks the basic blocks backward and removes the transfer instructions whose
+ * destination is overwritten before it's read, e.g. the moves of `shift_registers`.
+ * Every register is assumed to be live at the end of a basic block.
+ */
+i64 eliminate_dead_moves(KaosIR* program, bool* removed)
+{
+    i64 removed_count = 0;
+    u64 live = IR_ALL_REGS;
+
+    for (i64 i = program->size - 1; i >= 0; i--) {
+        if (removed[i])
+            continue;
+
+        KaosInstEffects effects = get_inst_effects(&program->arr[i]);
+
+        if (effects.is_barrier) {
+            live = IR_ALL_REGS;
+            continue;
+        }
+
+        if (effects.is_pure && effects.defs != 0 && (effects.defs & live) == 0) {
+            removed[i] = true;
+            removed_count++;
+            continue;
+        }
+
+        live = (live & ~effects.defs) | effects.uses;
+    }
+
+    return removed_count;
+}
+
+/*
+ * The registers that are read (might be more) and written (certainly) by an instruction.
+ * Anything that transfers the control or isn't known to the optimizer is a barrier.
+ */
+KaosInstEffects get_inst_effects(KaosInst* inst)
+{
+    KaosInstEffects effects;
+    effects.uses = 0;
+    effects.defs = 0;
+    effects.is_pure = false;
+    effects.is_barrier = false;
+    effects.clobbers_registers = false;
+    effects.clobbers_memory = false;
+
+    switch (inst->op_code) {
+    // >>> Function Declaration <<<
+    case DECLARE_ARG:
+        break;
+    case GETARG:
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    // >>> Function Calls <<<
+    case PREPARE:
+    case PUTARGI:
+        break;
+    case PUTARGR:
+        effects.uses = IR_REG_BIT(inst->op1.reg);
+        break;
+    case RETVAL:
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    // >>> Transfer Operations <<<
+    case MOVR:
+        effects.uses = IR_REG_BIT(inst->op2.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        effects.is_pure = true;
+        break;
+    case MOVI:
+    case REF_ALLOCAI:
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        effects.is_pure = true;
+        break;
+    case FMOV:
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        effects.is_pure = true;
+        break;
+    case FMOVR:
+        effects.uses = IR_FREG_BIT(inst->op2.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        effects.is_pure = true;
+        break;
+    case ALLOCAI:
+        break;
+    // >>> Load Operations <<<
+    case LDR:
+    case LDXI:
+        effects.uses = IR_REG_BIT(inst->op2.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    case LDXR:
+        effects.uses = IR_REG_BIT(inst->op2.reg) | IR_REG_BIT(inst->op3.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    case FLDR:
+    case FLDXI:
+        effects.uses = IR_REG_BIT(inst->op2.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        break;
+    case FLDXR:
+        effects.uses = IR_REG_BIT(inst->op2.reg) | IR_REG_BIT(inst->op3.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        break;
+    // >>> Store Operations <<<
+    case STR:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op2.reg);
+        effects.clobbers_memory = true;
+        break;
+    case STXR:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op2.reg) | IR_REG_BIT(inst->op3.reg);
+        effects.clobbers_memory = true;
+        break;
+    case STXI:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op3.reg);
+        effects.clobbers_memory = true;
+        break;
+    case FSTR:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_FREG_BIT(inst->op2.reg);
+        effects.clobbers_memory = true;
+        break;
+    case FSTXR:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op2.reg) | IR_FREG_BIT(inst->op3.reg);
+        effects.clobbers_memory = true;
+        break;
+    case FSTXI:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_FREG_BIT(inst->op3.reg);
+        effects.clobbers_memory = true;
+        break;
+    // >>> Binary Arithmetic Operations <<<
+    case ADDR:
+    case SUBR:
+    case MULR:
+    case DIVR:
+    case MODR:
+    case ANDR:
+    case ORR:
+    case XORR:
+    case LSHR:
+    case RSHR:
+    case EQR:
+    case NER:
+    case GTR:
+    case LTR:
+    case GER:
+    case LER:
+        effects.uses = IR_REG_BIT(inst->op2.reg) | IR_REG_BIT(inst->op3.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    case ADDI:
+    case SUBI:
+    case MULI:
+    case DIVI:
+    case MODI:
+    case ANDI:
+    case ORI:
+    case XORI:
+    case LSHI:
+    case RSHI:
+    case NEGR:
+    case NOTR:
+        effects.uses = IR_REG_BIT(inst->op2.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    // >>> Binary Floating-point Arithmetic Operations <<<
+    case FADDR:
+    case FSUBR:
+    case FMULR:
+    case FDIVR:
+        effects.uses = IR_FREG_BIT(inst->op2.reg) | IR_FREG_BIT(inst->op3.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        break;
+    case FNEGR:
+        effects.uses = IR_FREG_BIT(inst->op2.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        break;
+    case FEQR:
+    case FNER:
+    case FGTR:
+    case FLTR:
+    case FGER:
+    case FLER:
+        effects.uses = IR_FREG_BIT(inst->op2.reg) | IR_FREG_BIT(inst->op3.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    // >>> Conversions <<<
+    case EXTR:
+        effects.uses = IR_REG_BIT(inst->op2.reg);
+        effects.defs = IR_FREG_BIT(inst->op1.reg);
+        break;
+    case TRUNCR:
+        effects.uses = IR_FREG_BIT(inst->op2.reg);
+        effects.defs = IR_REG_BIT(inst->op1.reg);
+        break;
+    // >>> Non-Atomic Instructions <<<
+    case DYN_COMP_ACCESS: case DYN_COMP_UNSHARE_ELEMENT:
+        effects.uses |= IR_REG_BIT(inst->op3.reg);
+        // fall through
+    case DYN_GET_COMP_SIZE: case DYN_COMP_SHARE: case DYN_COMP_UNSHARE:
+        effects.uses |= IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op2.reg);
+        // fall through
+    case DYN_ADD: case DYN_SUB: case DYN_MUL: case DYN_DIV: case DYN_NEG:
+    case DYN_EQR: case DYN_NER: case DYN_GTR: case DYN_LTR: case DYN_GER: case DYN_LER:
+    case DYN_LAND: case DYN_LOR: case DYN_LNOT:
+    case DYN_PRNT: case DYN_ECHO: case DYN_PRETTY_PRNT: case DYN_PRETTY_ECHO:
+    case DYN_EXIT:
+    case DYN_STR_INDEX_DELETE: case DYN_LIST_INDEX_DELETE: case DYN_DICT_KEY_DELETE:
+    case DYN_STR_INDEX_ACCESS:
+    case DYN_LIST_INDEX_UPDATE: case DYN_DICT_KEY_UPDATE:
+    case DYN_BOOL_TO_STR: case DYN_STR_TO_BOOL:
+    case DYN_NEW_LIST: case DYN_NEW_DICT:
+    case DYN_LIST_APPEND: case DYN_LIST_EXTEND: case DYN_LIST_INSERT:
+    case DYN_LIST_KERNEL:
+    case DYN_STR_UNSHARE: case DYN_STR_APPEND:
+    case DYN_BREAK: case DYN_BREAK_HANDLE:
+        // The lowerings use the fixed registers below and R(3) only as a scratch register
+        effects.uses |= IR_REG_BIT(R0) | IR_REG_BIT(R1) | IR_REG_BIT(R2) | IR_REG_BIT(R4) | IR_REG_BIT(R5)
+            | IR_REG_BIT(R11) | IR_REG_BIT(R12) | IR_REG_BIT(R13) | IR_FREG_BIT(R1) | IR_FREG_BIT(R2);
+        effects.clobbers_registers = true;
+        effects.clobbers_memory = true;
+        break;
+    default:
+        effects.uses = IR_ALL_REGS;
+        effects.is_barrier = true;
+        effects.clobbers_registers = true;
+        effects.clobbers_memory = true;
+        break;
+    }
+
+    return effects;
+}
+
+i64 compact_program(KaosIR* program, bool* removed)
+{
+    i64 j = 0;
+    for (i64 i = 0; i < program->size; i++) {
+        if (!removed[i])
+            program->arr[j++] = program->arr[i];
+    }
+
+    i64 removed_count = program->size - j;
+    program->size = j;
+    return removed_count;
+}
@@ -0,0 +1,72 @@
+/*
+ * Description: Peephole optimizer of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef KAOS_COMPILER_OPTIMIZER_H
+#define KAOS_COMPILER_OPTIMIZER_H
+
+#include "compiler.h"
+#include "../vm/cpu.h"
+
+// Register masks, integer registers take the lower half and the floating-point registers the upper half
+#define IR_REG_BIT(reg) ((reg) < IR_NUM_REGISTERS ? (u64)1 << (reg) : 0)
+#define IR_FREG_BIT(reg) ((reg) < IR_NUM_REGISTERS ? (u64)1 << ((reg) + IR_NUM_REGISTERS) : 0)
+#define IR_ALL_REGS (~(u64)0)
+
+#define IR_MEMORY_TABLE_SIZE 32
+
+typedef struct KaosInstEffects {
+    u64 uses;
+    u64 defs;
+    bool is_pure;
+    bool is_barrier;
+    bool clobbers_registers;
+    bool clobbers_memory;
+} KaosInstEffects;
+
+enum KnownRegisterKind { KNOWN_NONE, KNOWN_IMM, KNOWN_SLOT };
+
+typedef struct KnownRegister {
+    enum KnownRegisterKind kind;
+    i64 value;
+} KnownRegister;
+
+typedef struct KnownMemory {
+    i64 slot;
+    i64 offset;
+    i64 size;
+    bool is_float;
+    i64 reg;
+} KnownMemory;
+
+typedef i64 (*KaosIRPass)(KaosIR* program, bool* removed);
+
+i64 optimize(KaosIR* program, unsigned short level);
+void forget_registers(KnownRegister* known);
+bool is_known(KnownRegister* known, enum IRRegister reg, enum KnownRegisterKind kind, i64 value);
+i64 forget_memory(KnownMemory* memory, i64 memory_size, i64 slot, i64 offset, i64 size);
+i64 forget_memory_of_registers(KnownMemory* memory, i64 memory_size, u64 defs);
+i64 forward_known_values(KaosIR* program, bool* removed);
+i64 eliminate_dead_moves(KaosIR* program, bool* removed);
+KaosInstEffects get_inst_effects(KaosInst* inst);
+i64 compact_program(KaosIR* program, bool* removed);
+
+#endif
@@ -0,0 +1,887 @@
+/*
+ * Description: SSA form of the KaosIR of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "compiler_ssa.h"
+
+/*
+ * Splits the program into basic blocks and connects them through the forward jumps,
+ * which land on the `PATCH` instruction with the same id, and the backward jumps,
+ * which land on the label with the same id.
+ */
+KaosCFG* build_cfg(KaosIR* program, bool* removed)
+{
+    KaosCFG* cfg = malloc(sizeof *cfg);
+    cfg->blocks = malloc((program->size + 1) * sizeof(KaosBlock));
+    cfg->block_count = 0;
+
+    i64 patch_count = 0;
+    i64 label_count = 0;
+    for (i64 i = 0; i < program->size; i++) {
+        KaosInst* inst = &program->arr[i];
+        if (inst->op_code == PATCH && inst->op1.value.i >= patch_count)
+            patch_count = inst->op1.value.i + 1;
+        if ((inst->op_code == DECLARE_LABEL || inst->op_code == PROLOG) && inst->op1.value.i >= label_count)
+            label_count = inst->op1.value.i + 1;
+    }
+
+    i64* patch_blocks = malloc(patch_count * sizeof(i64));
+    for (i64 i = 0; i < patch_count; i++)
+        patch_blocks[i] = SSA_NONE;
+    i64* label_blocks = malloc(label_count * sizeof(i64));
+    for (i64 i = 0; i < label_count; i++)
+        label_blocks[i] = SSA_NONE;
+
+    KaosBlock* block = NULL;
+    for (i64 i = 0; i < program->size; i++) {
+        if (removed[i])
+            continue;
+
+        KaosInst* inst = &program->arr[i];
+        if (block == NULL || is_block_leader(inst)) {
+            block = &cfg->blocks[cfg->block_count++];
+            block->start = i;
+            block->successor_count = 0;
+            block->exits = false;
+            block->live_in = 0;
+            block->live_out = 0;
+        }
+        block->end = i + 1;
+
+        if (inst->op_code == PATCH)
+            patch_blocks[inst->op1.value.i] = cfg->block_count - 1;
+        if (inst->op_code == DECLARE_LABEL || inst->op_code == PROLOG)
+            label_blocks[inst->op1.value.i] = cfg->block_count - 1;
+
+        if (is_block_terminator(inst))
+            block = NULL;
+    }
+
+    for (i64 b = 0; b < cfg->block_count; b++) {
+        block = &cfg->blocks[b];
+        KaosInst* inst = &program->arr[block->end - 1];
+
+        bool falls_through = true;
+        i64 target = SSA_NONE;
+        switch (inst->op_code) {
+        case BEQR:
+        case BEQI:
+            target = inst->op3.value.i < patch_count ? patch_blocks[inst->op3.value.i] : SSA_NONE;
+            block->exits = target == SSA_NONE;
+            break;
+        case JMPI_FORWARD:
+            falls_through = false;
+            target = inst->op1.value.i < patch_count ? patch_blocks[inst->op1.value.i] : SSA_NONE;
+            block->exits = target == SSA_NONE;
+            break;
+        case JMPI:
+            falls_through = false;
+            target = inst->op1.value.i < label_count ? label_blocks[inst->op1.value.i] : SSA_NONE;
+            block->exits = target == SSA_NONE;
+            break;
+        case RETR:
+        case RETI:
+        case HLT:
+            // The registers are local to the function, nothing is live after it returns
+            falls_through = false;
+            break;
+        default:
+            break;
+        }
+
+        if (target != SSA_NONE)
+            block->successors[block->successor_count++] = target;
+        if (falls_through) {
+            if (b + 1 < cfg->block_count)
+                block->successors[block->successor_count++] = b + 1;
+            else
+                block->exits = true;
+        }
+    }
+
+    free(patch_blocks);
+    free(label_blocks);
+    return cfg;
+}
+
+void free_cfg(KaosCFG* cfg)
+{
+    free(cfg->blocks);
+    free(cfg);
+}
+
+bool is_block_leader(KaosInst* inst)
+{
+    switch (inst->op_code) {
+    case PATCH:
+    case DECLARE_LABEL:
+    case PROLOG:
+    case MAIN_PROLOG:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool is_block_terminator(KaosInst* inst)
+{
+    switch (inst->op_code) {
+    case BEQR:
+    case BEQI:
+    case JMPI:
+    case JMPI_FORWARD:
+    case RETR:
+    case RETI:
+    case HLT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+KaosSSA* init_ssa()
+{
+    KaosSSA* ssa = malloc(sizeof *ssa);
+    ssa->value_capacity = SSA_VALUES_INITIAL_CAPACITY;
+    ssa->values = malloc(ssa->value_capacity * sizeof(KaosSSAValue));
+    ssa->value_count = 0;
+    ssa->table_capacity = SSA_VALUES_INITIAL_CAPACITY * 2;
+    ssa->table = malloc(ssa->table_capacity * sizeof(i64));
+    for (i64 i = 0; i < ssa->table_capacity; i++)
+        ssa->table[i] = SSA_NONE;
+    enter_block(ssa);
+    return ssa;
+}
+
+void free_ssa(KaosSSA* ssa)
+{
+    free(ssa->values);
+    free(ssa->table);
+    free(ssa);
+}
+
+// The registers hold the values that are live into the block, nothing is known about them
+void enter_block(KaosSSA* ssa)
+{
+    for (i64 i = 0; i < IR_NUM_REGISTERS; i++) {
+        ssa->regs[i] = new_value(ssa, NULL, false);
+        ssa->fregs[i] = new_value(ssa, NULL, true);
+    }
+    ssa->memory_size = 0;
+}
+
+i64 new_value(KaosSSA* ssa, KaosValueKey* key, bool is_float)
+{
+    if (ssa->value_count == ssa->value_capacity) {
+        ssa->value_capacity *= 2;
+        ssa->values = realloc(ssa->values, ssa->value_capacity * sizeof(KaosSSAValue));
+    }
+
+    KaosSSAValue* value = &ssa->values[ssa->value_count];
+    if (key != NULL)
+        value->key = *key;
+    else
+        value->key.op_code = SSA_NONE;
+    value->is_float = is_float;
+    value->holder = SSA_NONE;
+    value->slot = SSA_NONE;
+    value->is_constant = false;
+    value->constant = 0;
+
+    if (key != NULL && key->op_code == REF_ALLOCAI)
+        value->slot = key->operands[0];
+    if (key != NULL && key->op_code == MOVI) {
+        value->is_constant = true;
+        value->constant = key->operands[0];
+    }
+
+    return ssa->value_count++;
+}
+
+u64 hash_value_key(KaosValueKey* key)
+{
+    u64 hash = 14695981039346656037ULL;
+    hash = (hash ^ (u64)key->op_code) * 1099511628211ULL;
+    for (i64 i = 0; i < 3; i++)
+        hash = (hash ^ (u64)key->operands[i]) * 1099511628211ULL;
+    return hash;
+}
+
+i64 find_value(KaosSSA* ssa, KaosValueKey* key)
+{
+    u64 mask = ssa->table_capacity - 1;
+    for (u64 i = hash_value_key(key) & mask; ssa->table[i] != SSA_NONE; i = (i + 1) & mask) {
+        KaosValueKey* other = &ssa->values[ssa->table[i]].key;
+        if (memcmp(other, key, sizeof(KaosValueKey)) == 0)
+            return ssa->table[i];
+    }
+    return SSA_NONE;
+}
+
+void insert_value(KaosSSA* ssa, i64 value)
+{
+    // Keep the table at most half full
+    if (ssa->value_count * 2 > ssa->table_capacity) {
+        i64* table = ssa->table;
+        i64 table_capacity = ssa->table_capacity;
+        ssa->table_capacity *= 2;
+        ssa->table = malloc(ssa->table_capacity * sizeof(i64));
+        for (i64 i = 0; i < ssa->table_capacity; i++)
+            ssa->table[i] = SSA_NONE;
+        for (i64 i = 0; i < table_capacity; i++) {
+            if (table[i] != SSA_NONE) {
+                u64 mask = ssa->table_capacity - 1;
+                u64 j = hash_value_key(&ssa->values[table[i]].key) & mask;
+                while (ssa->table[j] != SSA_NONE)
+                    j = (j + 1) & mask;
+                ssa->table[j] = table[i];
+            }
+        }
+        free(table);
+    }
+
+    u64 mask = ssa->table_capacity - 1;
+    u64 i = hash_value_key(&ssa->values[value].key) & mask;
+    while (ssa->table[i] != SSA_NONE)
+        i = (i + 1) & mask;
+    ssa->table[i] = value;
+}
+
+// A register that holds the value right now, preferably the one that it was defined into
+i64 find_holder(KaosSSA* ssa, i64 value, bool is_float)
+{
+    i64* regs = is_float ? ssa->fregs : ssa->regs;
+    i64 holder = ssa->values[value].holder;
+    if (holder != SSA_NONE && regs[holder] == value)
+        return holder;
+
+    for (i64 i = 0; i < IR_NUM_REGISTERS; i++) {
+        if (regs[i] == value) {
+            ssa->values[value].holder = i;
+            return i;
+        }
+    }
+    return SSA_NONE;
+}
+
+// The registers starting from the call argument offsets and the promoted ones are left alone
+bool is_tracked_register(KaosOp* op)
+{
+    return op->type == IR_REG && op->reg < IR_NUM_REGISTERS;
+}
+
+void propagate_copy(KaosSSA* ssa, KaosOp* op, bool is_float)
+{
+    if (!is_tracked_register(op))
+        return;
+
+    i64 value = is_float ? ssa->fregs[op->reg] : ssa->regs[op->reg];
+    i64 holder = find_holder(ssa, value, is_float);
+    if (holder != SSA_NONE)
+        op->reg = holder;
+}
+
+/*
+ * Reads the operands of the instructions that are lowered into a single
+ * machine instruction from the registers that their values were defined into,
+ * so the copies in between become dead.
+ */
+void propagate_copies(KaosSSA* ssa, KaosInst* inst)
+{
+    switch (inst->op_code) {
+    case PUTARGR:
+    case RETR:
+        propagate_copy(ssa, &inst->op1, false);
+        break;
+    case BEQR:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op2, false);
+        break;
+    case BEQI:
+        propagate_copy(ssa, &inst->op1, false);
+        break;
+    case MOVR:
+    case LDR:
+    case LDXI:
+    case FLDR:
+    case FLDXI:
+    case ADDI: case SUBI: case MULI: case DIVI: case MODI:
+    case ANDI: case ORI: case XORI: case LSHI: case RSHI:
+    case NEGR: case NOTR:
+    case EXTR:
+        propagate_copy(ssa, &inst->op2, false);
+        break;
+    case FMOVR:
+    case FNEGR:
+    case TRUNCR:
+        propagate_copy(ssa, &inst->op2, true);
+        break;
+    case LDXR:
+    case FLDXR:
+    case ADDR: case SUBR: case MULR: case DIVR: case MODR:
+    case ANDR: case ORR: case XORR: case LSHR: case RSHR:
+    case EQR: case NER: case GTR: case LTR: case GER: case LER:
+        propagate_copy(ssa, &inst->op2, false);
+        propagate_copy(ssa, &inst->op3, false);
+        break;
+    case FADDR: case FSUBR: case FMULR: case FDIVR:
+    case FEQR: case FNER: case FGTR: case FLTR: case FGER: case FLER:
+        propagate_copy(ssa, &inst->op2, true);
+        propagate_copy(ssa, &inst->op3, true);
+        break;
+    case STR:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op2, false);
+        break;
+    case STXR:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op2, false);
+        propagate_copy(ssa, &inst->op3, false);
+        break;
+    case STXI:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op3, false);
+        break;
+    case FSTR:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op2, true);
+        break;
+    case FSTXR:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op2, false);
+        propagate_copy(ssa, &inst->op3, true);
+        break;
+    case FSTXI:
+        propagate_copy(ssa, &inst->op1, false);
+        propagate_copy(ssa, &inst->op3, true);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * The key of an instruction that computes its destination only from its operands.
+ * Returns false for anything else, including the operands that aren't tracked.
+ */
+bool get_value_key(KaosSSA* ssa, KaosInst* inst, KaosValueKey* key, bool* is_float)
+{
+    memset(key, 0, sizeof *key);
+    key->op_code = inst->op_code;
+    *is_float = false;
+
+    if (!is_tracked_register(&inst->op1))
+        return false;
+
+    switch (inst->op_code) {
+    case MOVI:
+    case REF_ALLOCAI:
+        key->operands[0] = inst->op2.value.i;
+        return true;
+    case FMOV:
+        key->operands[0] = inst->op2.value.i;
+        *is_float = true;
+        return true;
+    case ADDI: case SUBI: case MULI: case DIVI: case MODI:
+    case ANDI: case ORI: case XORI: case LSHI: case RSHI:
+        if (!is_tracked_register(&inst->op2))
+            return false;
+        key->operands[0] = ssa->regs[inst->op2.reg];
+        key->operands[1] = inst->op3.value.i;
+        return true;
+    case NEGR:
+    case NOTR:
+    case EXTR:
+    case FNEGR:
+    case TRUNCR: {
+        if (!is_tracked_register(&inst->op2))
+            return false;
+        bool is_float_operand = inst->op_code == FNEGR || inst->op_code == TRUNCR;
+        key->operands[0] = is_float_operand ? ssa->fregs[inst->op2.reg] : ssa->regs[inst->op2.reg];
+        *is_float = inst->op_code == FNEGR || inst->op_code == EXTR;
+        return true;
+    }
+    case ADDR: case SUBR: case MULR: case DIVR: case MODR:
+    case ANDR: case ORR: case XORR: case LSHR: case RSHR:
+    case EQR: case NER: case GTR: case LTR: case GER: case LER:
+    case FADDR: case FSUBR: case FMULR: case FDIVR:
+    case FEQR: case FNER: case FGTR: case FLTR: case FGER: case FLER: {
+        if (!is_tracked_register(&inst->op2) || !is_tracked_register(&inst->op3))
+            return false;
+        bool is_float_operand = (inst->op_code >= FADDR && inst->op_code <= FDIVR)
+            || (inst->op_code >= FEQR && inst->op_code <= FLER);
+        i64* regs = is_float_operand ? ssa->fregs : ssa->regs;
+        key->operands[0] = regs[inst->op2.reg];
+        key->operands[1] = regs[inst->op3.reg];
+        *is_float = inst->op_code >= FADDR && inst->op_code <= FDIVR;
+
+        // The order of the operands doesn't matter for these
+        switch (inst->op_code) {
+        case ADDR: case MULR: case ANDR: case ORR: case XORR: case EQR: case NER:
+        case FADDR: case FMULR: case FEQR: case FNER:
+            if (key->operands[0] > key->operands[1]) {
+                i64 operand = key->operands[0];
+                key->operands[0] = key->operands[1];
+                key->operands[1] = operand;
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+/*
+ * The cell that a load or a store accesses, its offset has to be known at compile-time.
+ * Returns false for anything else.
+ */
+bool get_memory_access(KaosSSA* ssa, KaosInst* inst, KaosMemoryFact* access)
+{
+    KaosOp* base = NULL;
+    KaosOp* value = NULL;
+    KaosOp* index = NULL;
+    access->offset = 0;
+    access->is_float = false;
+
+    switch (inst->op_code) {
+    case FLDR:
+        access->is_float = true;
+        // fall through
+    case LDR:
+        base = &inst->op2;
+        value = &inst->op1;
+        access->size = inst->op3.value.i;
+        break;
+    case FLDXI:
+        access->is_float = true;
+        // fall through
+    case LDXI:
+        base = &inst->op2;
+        value = &inst->op1;
+        access->offset = inst->op3.value.i;
+        access->size = inst->op4.value.i;
+        break;
+    case FLDXR:
+        access->is_float = true;
+        // fall through
+    case LDXR:
+        base = &inst->op2;
+        value = &inst->op1;
+        index = &inst->op3;
+        access->size = inst->op4.value.i;
+        break;
+    case FSTR:
+        access->is_float = true;
+        // fall through
+    case STR:
+        base = &inst->op1;
+        value = &inst->op2;
+        access->size = inst->op3.value.i;
+        break;
+    case FSTXI:
+        access->is_float = true;
+        // fall through
+    case STXI:
+        base = &inst->op1;
+        value = &inst->op3;
+        access->offset = inst->op2.value.i;
+        access->size = inst->op4.value.i;
+        break;
+    case FSTXR:
+        access->is_float = true;
+        // fall through
+    case STXR:
+        base = &inst->op1;
+        value = &inst->op3;
+        index = &inst->op2;
+        access->size = inst->op4.value.i;
+        break;
+    default:
+        return false;
+    }
+
+    if (!is_tracked_register(base) || !is_tracked_register(value))
+        return false;
+    access->base = ssa->regs[base->reg];
+    access->value = access->is_float ? ssa->fregs[value->reg] : ssa->regs[value->reg];
+
+    if (index != NULL) {
+        if (!is_tracked_register(index) || !ssa->values[ssa->regs[index->reg]].is_constant)
+            return false;
+        access->offset = ssa->values[ssa->regs[index->reg]].constant;
+    }
+    return true;
+}
+
+i64 find_memory_fact(KaosSSA* ssa, KaosMemoryFact* access)
+{
+    for (i64 i = 0; i < ssa->memory_size; i++) {
+        KaosMemoryFact* fact = &ssa->memory[i];
+        if (
+            fact->base == access->base &&
+            fact->offset == access->offset &&
+            fact->size == access->size &&
+            fact->is_float == access->is_float
+        )
+            return fact->value;
+    }
+    return SSA_NONE;
+}
+
+void add_memory_fact(KaosSSA* ssa, KaosMemoryFact* fact)
+{
+    if (ssa->memory_size < SSA_MEMORY_TABLE_SIZE)
+        ssa->memory[ssa->memory_size++] = *fact;
+}
+
+/*
+ * A store into a stack slot can only overwrite the cells of the same slot and the cells
+ * that are reached through an address that isn't a slot. A store through any other address
+ * might overwrite anything.
+ */
+void forget_memory_facts(KaosSSA* ssa, KaosMemoryFact* access)
+{
+    if (access == NULL || ssa->values[access->base].slot == SSA_NONE) {
+        ssa->memory_size = 0;
+        return;
+    }
+
+    i64 j = 0;
+    for (i64 i = 0; i < ssa->memory_size; i++) {
+        KaosMemoryFact* fact = &ssa->memory[i];
+        bool overlaps = ssa->values[fact->base].slot == SSA_NONE || (
+            fact->base == access->base
+            && fact->offset < access->offset + access->size
+            && access->offset < fact->offset + fact->size
+        );
+        if (!overlaps)
+            ssa->memory[j++] = *fact;
+    }
+    ssa->memory_size = j;
+}
+
+void rewrite_to_move(KaosInst* inst, bool is_float, i64 holder)
+{
+    inst->op_code = is_float ? FMOVR : MOVR;
+    memset(&inst->op2, 0, sizeof(KaosOp));
+    inst->op2.type = IR_REG;
+    inst->op2.reg = holder;
+    memset(&inst->op3, 0, sizeof(KaosOp));
+    memset(&inst->op4, 0, sizeof(KaosOp));
+}
+
+// Returns true if the destination already holds the value, otherwise it's copied from a register that does
+bool reuse_value(KaosSSA* ssa, KaosInst* inst, i64 value, bool is_float)
+{
+    i64* regs = is_float ? ssa->fregs : ssa->regs;
+    if (regs[inst->op1.reg] == value)
+        return true;
+
+    i64 holder = find_holder(ssa, value, is_float);
+    if (holder != SSA_NONE)
+        rewrite_to_move(inst, is_float, holder);
+    else
+        ssa->values[value].holder = inst->op1.reg;
+    regs[inst->op1.reg] = value;
+    return false;
+}
+
+void define_fresh_values(KaosSSA* ssa, KaosInstEffects* effects)
+{
+    for (i64 i = 0; i < IR_NUM_REGISTERS; i++) {
+        if (effects->clobbers_registers || effects->defs & IR_REG_BIT(i))
+            ssa->regs[i] = new_value(ssa, NULL, false);
+        if (effects->clobbers_registers || effects->defs & IR_FREG_BIT(i))
+            ssa->fregs[i] = new_value(ssa, NULL, true);
+    }
+}
+
+// Numbers the value that an instruction defines, returns true if the instruction is redundant
+bool number_inst(KaosSSA* ssa, KaosInst* inst)
+{
+    propagate_copies(ssa, inst);
+
+    // A copy gives its destination the same value
+    if (
+        (inst->op_code == MOVR || inst->op_code == FMOVR)
+        &&
+        is_tracked_register(&inst->op1)
+        &&
+        is_tracked_register(&inst->op2)
+    ) {
+        i64* regs = inst->op_code == FMOVR ? ssa->fregs : ssa->regs;
+        if (regs[inst->op1.reg] == regs[inst->op2.reg])
+            return true;
+        regs[inst->op1.reg] = regs[inst->op2.reg];
+        return false;
+    }
+
+    KaosValueKey key;
+    bool is_float;
+    if (get_value_key(ssa, inst, &key, &is_float)) {
+        i64 value = find_value(ssa, &key);
+        if (value != SSA_NONE)
+            return reuse_value(ssa, inst, value, is_float);
+
+        value = new_value(ssa, &key, is_float);
+        insert_value(ssa, value);
+        ssa->values[value].holder = inst->op1.reg;
+        if (is_float)
+            ssa->fregs[inst->op1.reg] = value;
+        else
+            ssa->regs[inst->op1.reg] = value;
+        return false;
+    }
+
+    KaosMemoryFact access;
+    bool is_known_access = get_memory_access(ssa, inst, &access);
+    switch (inst->op_code) {
+    case LDR: case LDXI: case LDXR:
+    case FLDR: case FLDXI: case FLDXR: {
+        if (!is_known_access)
+            break;
+
+        // The cell still holds the value that was stored into or loaded from it
+        i64 value = find_memory_fact(ssa, &access);
+        if (value != SSA_NONE)
+            return reuse_value(ssa, inst, value, access.is_float);
+
+        value = new_value(ssa, NULL, access.is_float);
+        ssa->values[value].holder = inst->op1.reg;
+        if (access.is_float)
+            ssa->fregs[inst->op1.reg] = value;
+        else
+            ssa->regs[inst->op1.reg] = value;
+        access.value = value;
+        add_memory_fact(ssa, &access);
+        return false;
+    }
+    case STR: case STXI: case STXR:
+    case FSTR: case FSTXI: case FSTXR:
+        if (!is_known_access) {
+            forget_memory_facts(ssa, NULL);
+            return false;
+        }
+
+        // Storing the value that the cell already holds is a no-op
+        if (find_memory_fact(ssa, &access) == access.value)
+            return true;
+
+        forget_memory_facts(ssa, &access);
+        add_memory_fact(ssa, &access);
+        return false;
+    default:
+        break;
+    }
+
+    KaosInstEffects effects = get_inst_effects(inst);
+    if (effects.is_barrier) {
+        enter_block(ssa);
+        return false;
+    }
+
+    define_fresh_values(ssa, &effects);
+    if (effects.clobbers_memory)
+        forget_memory_facts(ssa, NULL);
+    return false;
+}
+
+/*
+ * Builds the SSA form of every basic block and numbers its values. The instructions
+ * that compute a value that is already in a register become copies of it (value numbering),
+ * the repeated loads from the unmodified cells are removed the same way and the operands are read
+ * from the registers that their values were defined into (copy propagation).
+ */
+i64 number_values(KaosIR* program, bool* removed)
+{
+    i64 removed_count = 0;
+    KaosCFG* cfg = build_cfg(program, removed);
+    KaosSSA* ssa = init_ssa();
+
+    for (i64 b = 0; b < cfg->block_count; b++) {
+        KaosBlock* block = &cfg->blocks[b];
+        enter_block(ssa);
+
+        for (i64 i = block->start; i < block->end; i++) {
+            if (removed[i])
+                continue;
+
+            if (number_inst(ssa, &program->arr[i])) {
+                removed[i] = true;
+                removed_count++;
+            }
+        }
+    }
+
+    free_ssa(ssa);
+    free_cfg(cfg);
+    return removed_count;
+}
+
+// Same as the effects, except that the jumps and the returns only read the registers that they compare or return
+KaosInstEffects get_inst_liveness(KaosInst* inst)
+{
+    KaosInstEffects effects = get_inst_effects(inst);
+
+    switch (inst->op_code) {
+    case RETR:
+        effects.uses = IR_REG_BIT(inst->op1.reg);
+        effects.is_barrier = false;
+        break;
+    case RETI:
+    case HLT:
+        effects.uses = 0;
+        effects.is_barrier = false;
+        break;
+    case BEQR:
+        effects.uses = IR_REG_BIT(inst->op1.reg) | IR_REG_BIT(inst->op2.reg);
+        effects.is_barrier = false;
+        break;
+    case BEQI:
+        effects.uses = IR_REG_BIT(inst->op1.reg);
+        effects.is_barrier = false;
+        break;
+    case JMPI:
+    case JMPI_FORWARD:
+    case PATCH:
+    case DECLARE_LABEL:
+        effects.uses = 0;
+        effects.is_barrier = false;
+        break;
+    default:
+        break;
+    }
+
+    return effects;
+}
+
+// The instructions that neither have a side effect nor trap
+bool is_removable(KaosInst* inst, KaosInstEffects* effects)
+{
+    if (effects->is_pure)
+        return true;
+
+    switch (inst->op_code) {
+    case LDR: case LDXR: case LDXI:
+    case FLDR: case FLDXR: case FLDXI:
+    case ADDR: case ADDI: case SUBR: case SUBI: case MULR: case MULI:
+    case ANDR: case ANDI: case ORR: case ORI: case XORR: case XORI:
+    case LSHR: case LSHI: case RSHR: case RSHI:
+    case NEGR: case NOTR:
+    case EQR: case NER: case GTR: case LTR: case GER: case LER:
+    case FADDR: case FSUBR: case FMULR: case FDIVR: case FNEGR:
+    case FEQR: case FNER: case FGTR: case FLTR: case FGER: case FLER:
+    case EXTR: case TRUNCR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void solve_liveness(KaosIR* program, bool* removed, KaosCFG* cfg)
+{
+    for (i64 b = 0; b < cfg->block_count; b++) {
+        cfg->blocks[b].live_in = 0;
+        cfg->blocks[b].live_out = 0;
+    }
+
+    bool is_changed = true;
+    while (is_changed) {
+        is_changed = false;
+
+        for (i64 b = cfg->block_count - 1; b >= 0; b--) {
+            KaosBlock* block = &cfg->blocks[b];
+
+            u64 live = block->exits ? IR_ALL_REGS : 0;
+            for (i64 s = 0; s < block->successor_count; s++)
+                live |= cfg->blocks[block->successors[s]].live_in;
+            block->live_out = live;
+
+            for (i64 i = block->end - 1; i >= block->start; i--) {
+                if (removed[i])
+                    continue;
+
+                KaosInstEffects effects = get_inst_liveness(&program->arr[i]);
+                if (effects.is_barrier)
+                    live = IR_ALL_REGS;
+                else
+                    live = (live & ~effects.defs) | effects.uses;
+            }
+
+            if (live != block->live_in) {
+                block->live_in = live;
+                is_changed = true;
+            }
+        }
+    }
+}
+
+/*
+ * Removes the instructions that compute a value which is never read, the registers
+ * that are live at the end of a basic block are solved over the control flow graph
+ * instead of assuming that all of them are.
+ */
+i64 eliminate_dead_code(KaosIR* program, bool* removed)
+{
+    i64 removed_count = 0;
+    KaosCFG* cfg = build_cfg(program, removed);
+
+    for (i64 round = 0; round < SSA_MAX_DCE_ROUNDS; round++) {
+        solve_liveness(program, removed, cfg);
+
+        i64 round_removed_count = 0;
+        for (i64 b = 0; b < cfg->block_count; b++) {
+            KaosBlock* block = &cfg->blocks[b];
+            u64 live = block->live_out;
+
+            for (i64 i = block->end - 1; i >= block->start; i--) {
+                if (removed[i])
+                    continue;
+
+                KaosInst* inst = &program->arr[i];
+                KaosInstEffects effects = get_inst_liveness(inst);
+                if (effects.is_barrier) {
+                    live = IR_ALL_REGS;
+                    continue;
+                }
+
+                if (effects.defs != 0 && (effects.defs & live) == 0 && is_removable(inst, &effects)) {
+                    removed[i] = true;
+                    round_removed_count++;
+                    continue;
+                }
+
+                live = (live & ~effects.defs) | effects.uses;
+            }
+        }
+
+        removed_count += round_removed_count;
+        if (round_removed_count == 0)
+            break;
+    }
+
+    free_cfg(cfg);
+    return removed_count;
+}
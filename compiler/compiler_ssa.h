@@ -0,0 +1,127 @@
+/*
+ * Description: SSA form of the KaosIR of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef KAOS_COMPILER_SSA_H
+#define KAOS_COMPILER_SSA_H
+
+#include "compiler_optimizer.h"
+
+#define SSA_NONE -1
+#define SSA_VALUES_INITIAL_CAPACITY 1024
+#define SSA_MEMORY_TABLE_SIZE 64
+// The liveness is solved again after each round of removals, up to this many rounds
+#define SSA_MAX_DCE_ROUNDS 8
+
+/*
+ * A basic block of the KaosIR, the instructions in [start, end).
+ * The control leaves it through at most two successors, a block that exits
+ * to somewhere that isn't known has every register live at its end.
+ */
+typedef struct KaosBlock {
+    i64 start;
+    i64 end;
+    i64 successors[2];
+    i64 successor_count;
+    bool exits;
+    u64 live_in;
+    u64 live_out;
+} KaosBlock;
+
+typedef struct KaosCFG {
+    KaosBlock* blocks;
+    i64 block_count;
+} KaosCFG;
+
+// The operation and the operands (value numbers or immediates) that compute a value
+typedef struct KaosValueKey {
+    i64 op_code;
+    i64 operands[3];
+} KaosValueKey;
+
+/*
+ * An SSA value is defined once, the registers only hold them. The instructions that
+ * compute the same key get the same value, a copy gives its destination the value of its source.
+ */
+typedef struct KaosSSAValue {
+    KaosValueKey key;
+    bool is_float;
+    // The register that the value was defined into, the copies are read from it instead
+    i64 holder;
+    // The stack slot whose address is the value, its cells can't be reached through any other slot
+    i64 slot;
+    bool is_constant;
+    i64 constant;
+} KaosSSAValue;
+
+// The value that is known to be in a cell of the memory
+typedef struct KaosMemoryFact {
+    i64 base;
+    i64 offset;
+    i64 size;
+    bool is_float;
+    i64 value;
+} KaosMemoryFact;
+
+typedef struct KaosSSA {
+    KaosSSAValue* values;
+    i64 value_count;
+    i64 value_capacity;
+    // Open addressing over the keyed values
+    i64* table;
+    i64 table_capacity;
+    i64 regs[IR_NUM_REGISTERS];
+    i64 fregs[IR_NUM_REGISTERS];
+    KaosMemoryFact memory[SSA_MEMORY_TABLE_SIZE];
+    i64 memory_size;
+} KaosSSA;
+
+KaosCFG* build_cfg(KaosIR* program, bool* removed);
+void free_cfg(KaosCFG* cfg);
+bool is_block_leader(KaosInst* inst);
+bool is_block_terminator(KaosInst* inst);
+KaosSSA* init_ssa();
+void free_ssa(KaosSSA* ssa);
+void enter_block(KaosSSA* ssa);
+i64 new_value(KaosSSA* ssa, KaosValueKey* key, bool is_float);
+u64 hash_value_key(KaosValueKey* key);
+i64 find_value(KaosSSA* ssa, KaosValueKey* key);
+void insert_value(KaosSSA* ssa, i64 value);
+i64 find_holder(KaosSSA* ssa, i64 value, bool is_float);
+bool is_tracked_register(KaosOp* op);
+void propagate_copy(KaosSSA* ssa, KaosOp* op, bool is_float);
+void propagate_copies(KaosSSA* ssa, KaosInst* inst);
+bool get_value_key(KaosSSA* ssa, KaosInst* inst, KaosValueKey* key, bool* is_float);
+bool get_memory_access(KaosSSA* ssa, KaosInst* inst, KaosMemoryFact* access);
+i64 find_memory_fact(KaosSSA* ssa, KaosMemoryFact* access);
+void add_memory_fact(KaosSSA* ssa, KaosMemoryFact* fact);
+void forget_memory_facts(KaosSSA* ssa, KaosMemoryFact* access);
+void rewrite_to_move(KaosInst* inst, bool is_float, i64 holder);
+bool reuse_value(KaosSSA* ssa, KaosInst* inst, i64 value, bool is_float);
+void define_fresh_values(KaosSSA* ssa, KaosInstEffects* effects);
+bool number_inst(KaosSSA* ssa, KaosInst* inst);
+i64 number_values(KaosIR* program, bool* removed);
+KaosInstEffects get_inst_liveness(KaosInst* inst);
+bool is_removable(KaosInst* inst, KaosInstEffects* effects);
+void solve_liveness(KaosIR* program, bool* removed, KaosCFG* cfg);
+i64 eliminate_dead_code(KaosIR* program, bool* removed);
+
+#endif
@@ -150,6 +150,21 @@ void throw_error_base(
     case E_STACK_OVERFLOW:
         sprintf(error_msg, "Stack overflow! Report this error to https://github.com/chaos-lang/chaos/issues");
         break;
+    case E_LIST_LENGTH_MISMATCH:
+        sprintf(error_msg, "The lengths of the lists: %lld and %llu don't match for function: %s", lld1, llu1, str1);
+        break;
+    case E_NOT_A_NUMERIC_LIST:
+        sprintf(error_msg, "Non-numeric element at index: %lld for function: %s", lld1, str1);
+        break;
+    case E_EMPTY_LIST:
+        sprintf(error_msg, "Empty list for function: %s", str1);
+        break;
+    case E_UNDEFINED_DICT_KEY:
+        sprintf(error_msg, "Undefined key: %s for the dictionary!", str1);
+        break;
+    case E_TOO_MANY_ARGUMENTS:
+        sprintf(error_msg, "Too many arguments for function: %s (max %lld)", str1, lld1);
+        break;
     default:
         sprintf(error_msg, "Unkown error.");
         break;
@@ -214,7 +229,7 @@ void throw_error_base(
         free(line);
     }
 
-    if (code == E_INDEX_OUT_OF_RANGE || code == E_INDEX_OUT_OF_RANGE_STRING)
+    if ((code == E_INDEX_OUT_OF_RANGE || code == E_INDEX_OUT_OF_RANGE_STRING) && ast_stack != NULL)
         // Runtime error
         current_ast = (void *)ast_stack[ast_stack_p];
     else
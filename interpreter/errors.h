@@ -68,6 +68,11 @@ enum ExitCode {
     E_BREAK_CALL_OUTSIDE_LOOP,
     E_BREAK_CALL_MULTILINE_LOOP,
     E_STACK_OVERFLOW,
+    E_LIST_LENGTH_MISMATCH,
+    E_NOT_A_NUMERIC_LIST,
+    E_EMPTY_LIST,
+    E_UNDEFINED_DICT_KEY,
+    E_TOO_MANY_ARGUMENTS,
     E_PREEMPTIVE
 };
 
@@ -177,8 +177,9 @@ _Function* declareFunction(char *name, char *module, char *module_path, char *co
         end_function->next = NULL;
     }
 
-    function->call_patches = (int*)malloc(USHRT_MAX * 256 * sizeof(int));
+    function->call_patches = NULL;
     function->call_patches_size = 0;
+    function->call_patches_capacity = 0;
     function->should_inline = false;
 
     return function;
@@ -255,6 +256,22 @@ void resetFunctionParametersMode() {
 }
 
 _Function* getFunction(char *name, char *module) {
+    _Function* function = findFunction(name, module);
+    if (function != NULL)
+        return function;
+    if (phase == PROGRAM) {
+        if (scope_override != NULL)
+            free(scope_override);
+        throw_error(
+            E_UNDEFINED_FUNCTION,
+            name,
+            (module == NULL || strcmp(module, "") == 0) ? "<module>" : module
+        );
+    }
+    return NULL;
+}
+
+_Function* findFunction(char *name, char *module) {
     function_cursor = start_function;
     while (function_cursor != NULL) {
         if (module == NULL && strcmp(function_cursor->module, "") != 0) {
@@ -272,15 +289,6 @@ _Function* getFunction(char *name, char *module) {
         }
         function_cursor = function_cursor->next;
     }
-    if (phase == PROGRAM) {
-        if (scope_override != NULL)
-            free(scope_override);
-        throw_error(
-            E_UNDEFINED_FUNCTION,
-            name,
-            (module == NULL || strcmp(module, "") == 0) ? "<module>" : module
-        );
-    }
     return NULL;
 }
 
@@ -548,6 +556,7 @@ void freeFunction(_Function* function) {
     free(function->decision_functions.arr);
     free(function->decision_default);
     free(function->module);
+    free(function->call_patches);
     free(function);
 }
 
@@ -35,6 +35,8 @@
 typedef struct _Function _Function;
 typedef struct FunctionCall FunctionCall;
 
+#define CALL_PATCHES_INITIAL_CAPACITY 8
+
 #include "symbol.h"
 #include "errors.h"
 #if !defined(_WIN32) && !defined(_WIN64) && !defined(__CYGWIN__)
@@ -74,8 +76,16 @@ typedef struct _Function {
     bool is_compiled;
     int *call_patches;
     int call_patches_size;
+    int call_patches_capacity;
     Decl* ast;
     bool should_inline;
+    bool may_break;
+    bool is_reachable;
+    unsigned long ast_size;
+    unsigned long call_count;
+    unsigned long call_weight;
+    struct _Function** callees;
+    unsigned long callee_count;
 } _Function;
 
 _Function* function_cursor;
@@ -138,6 +148,7 @@ void endFunction();
 void freeFunctionParametersMode();
 void resetFunctionParametersMode();
 _Function* getFunction(char *name, char *module);
+_Function* findFunction(char *name, char *module);
 _Function* getFunctionByModuleContext(char *name, char *module_context);
 _Function* checkDuplicateFunction(char *name, char *module_path);
 void removeFunctionIfDefined(char *name);
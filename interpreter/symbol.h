@@ -64,7 +64,9 @@ typedef struct Symbol {
     enum Role role;
     struct _Function* param_of;
     long long addr;
+    long long reg;
     bool is_dynamic;
+    bool is_constant;
 } Symbol;
 
 Symbol* symbol_cursor;
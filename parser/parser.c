@@ -25,6 +25,7 @@
 extern bool disable_complex_mode;
 extern char *suggestions[1000];
 extern unsigned long long suggestions_length;
+extern string_array pruned_functions;
 
 bool compiling_a_function = false;
 
@@ -40,6 +41,9 @@ static struct option long_options[] =
     {"extra", required_argument, NULL, 'e'},
     {"keep", no_argument, NULL, 'k'},
     {"ast", no_argument, NULL, 'a'},
+    {"tier", required_argument, NULL, 't'},
+    {"gc-stats", no_argument, NULL, 'g'},
+    {"optimize", required_argument, NULL, 'O'},
     {NULL, 0, NULL, 0}
 };
 
@@ -48,13 +52,16 @@ int initParser(int argc, char** argv) {
     bool compiler_mode = false;
     bool compiler_fopen_fail = false;
     bool print_ast = false;
+    enum CpuTier tier = CPU_TIER_JIT;
+    bool gc_stats = false;
+    unsigned short optimization_level = 1;
     char *program_file = NULL;
     char *bin_file = NULL;
     // bool keep = false;
     // char *extra_flags = NULL;
 
     char opt;
-    while ((opt = getopt_long(argc, argv, "hvld:c:o:e:k:a:", long_options, NULL)) != -1)
+    while ((opt = getopt_long(argc, argv, "hvld:c:o:e:k:a:t:gO:", long_options, NULL)) != -1)
     {
         switch (opt) {
         case 'h':
@@ -89,6 +96,29 @@ int initParser(int argc, char** argv) {
         case 'a':
             print_ast = true;
             break;
+        case 't':
+            if (strcmp(optarg, "interpreter") == 0)
+                tier = CPU_TIER_INTERPRETER;
+            else if (strcmp(optarg, "jit") == 0)
+                tier = CPU_TIER_JIT;
+            else if (strcmp(optarg, "tiered") == 0)
+                tier = CPU_TIER_TIERED;
+            else {
+                print_help();
+                exit(E_INVALID_OPTION);
+            }
+            break;
+        case 'g':
+            gc_stats = true;
+            break;
+        case 'O':
+            if (strcmp(optarg, "0") == 0 || strcmp(optarg, "1") == 0 || strcmp(optarg, "2") == 0)
+                optimization_level = atoi(optarg);
+            else {
+                print_help();
+                exit(E_INVALID_OPTION);
+            }
+            break;
         case '?':
             switch (optopt) {
             case 'c':
@@ -215,10 +245,15 @@ int initParser(int argc, char** argv) {
         }
 
         KaosIR* program = compile(_ast_root);
+        i64 removed_inst_count = optimize(program, optimization_level);
 
         if (debug_level > 1) {
             printf("\nJIT Abstraction Layer:\n");
             emit(program);
+            printf("Optimizer removed %lld instructions\n", removed_inst_count);
+            printf("Pruned %u unreachable functions\n", pruned_functions.size);
+            for (unsigned i = 0; i < pruned_functions.size; i++)
+                printf("    %s\n", pruned_functions.arr[i]);
             if (debug_level == 2)
                 exit(0);
         }
@@ -227,7 +262,14 @@ int initParser(int argc, char** argv) {
             printf("\nJIT Runtime:\n");
 
         cpu *c = new_cpu(program, debug_level);
+        // The JIT dumps of the higher debug levels need the whole program lowered upfront
+        c->lazy_jit = debug_level < 3;
+        c->tier = c->lazy_jit ? tier : CPU_TIER_JIT;
+        c->gc_stats = gc_stats;
         run_cpu(c);
+        // The standard streams are closed before the exit, so the statistics can't wait for it
+        if (c->gc_stats)
+            gc_print_stats();
         free_cpu(c);
         // if (!is_interactive) {
         //     if (compiler_mode) {
@@ -35,6 +35,7 @@
 #ifndef CHAOS_COMPILER
 #include "../compiler/compiler.h"
 #include "../compiler/compiler_emit.h"
+#include "../compiler/compiler_optimizer.h"
 #endif
 
 #include "../ast/ast_print.h"
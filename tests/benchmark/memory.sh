@@ -0,0 +1,62 @@
+#!/bin/bash
+
+# Measures the peak resident set size and the peak virtual size of the programs in the tests
+# and the Rosetta Code examples, fails if any of them exceeds the limits or stops working under them
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+TESTS_DIR="$( dirname "$DIR" )"
+
+# Limits in kilobytes
+RSS_LIMIT=${RSS_LIMIT:-131072}
+VSZ_LIMIT=${VSZ_LIMIT:-1048576}
+
+failed=false
+rss_max=0
+vsz_max=0
+time_out=$(mktemp)
+massif_out=$(mktemp)
+
+printf "%-32s %14s %14s\n" "Program" "Peak RSS" "Peak VSZ"
+
+for filepath in $(find $TESTS_DIR $TESTS_DIR/rosetta -maxdepth 1 -name '*.kaos' | sort); do
+    filename=$(basename $filepath)
+    testname="${filename%.*}"
+    program="tests/${filepath#$TESTS_DIR/}"
+
+    # The peak resident set size is reported by the kernel
+    /usr/bin/time -o $time_out -f "%M" chaos $program > /dev/null 2>&1
+    rss=$(tail -n 1 $time_out)
+
+    # Every mapped page is counted as the heap, so the peak of it is the peak virtual size
+    valgrind --tool=massif --pages-as-heap=yes --massif-out-file=$massif_out chaos $program > /dev/null 2>&1
+    vsz=$(grep "^mem_heap_B=" $massif_out | cut -d= -f2 | sort -n | tail -n 1)
+    vsz=$(( ${vsz:-0} / 1024 ))
+
+    printf "%-32s %11s kB %11s kB\n" "${testname}" "${rss}" "${vsz}"
+
+    (( rss > rss_max )) && rss_max=$rss
+    (( vsz > vsz_max )) && vsz_max=$vsz
+
+    if (( rss > RSS_LIMIT || vsz > VSZ_LIMIT )); then
+        echo "Fail: over the limit"
+        failed=true
+    fi
+
+    # Overcommit-restricted environments fail the allocations that are beyond the limit,
+    # so the output under the limit has to match the output of the same program without it
+    out=$(chaos $program 2>&1)
+    test=$( ulimit -v $VSZ_LIMIT; chaos $program 2>&1 )
+    if [ "$test" != "$out" ]; then
+        echo "Fail: the output differs under the virtual memory limit"
+        failed=true
+    fi
+done
+
+rm -f $time_out $massif_out
+
+echo "Peak RSS: ${rss_max} kB (limit: ${RSS_LIMIT} kB)"
+echo "Peak VSZ: ${vsz_max} kB (limit: ${VSZ_LIMIT} kB)"
+
+if [ "$failed" = true ] ; then
+    exit 1
+fi
@@ -57,11 +57,28 @@ chaos -l && chaos --license && \
 chaos -a tests/everything.kaos && chaos --ast tests/everything.kaos && \
 echo -e "\nOK\n\n" && \
 
+echo -e "\nINFO: Test the execution tiers\n"
+chaos -t interpreter tests/everything.kaos && chaos --tier jit tests/everything.kaos && \
+chaos -t tiered tests/everything.kaos && \
+echo -e "\nOK\n\n" && \
+
+echo -e "\nINFO: Test the optimization levels\n"
+chaos -O 0 tests/everything.kaos && chaos --optimize 2 tests/everything.kaos && \
+echo -e "\nOK\n\n" && \
+
+echo -e "\nINFO: Test the garbage collector statistics\n"
+chaos -g tests/everything.kaos | grep "Garbage Collector:" && \
+chaos --gc-stats tests/everything.kaos | grep "Garbage Collector:" && \
+chaos -g tests/exit_int.kaos | grep "Garbage Collector:" && \
+echo -e "\nOK\n\n" && \
+
 echo -e "\nINFO: Test invalid argument messages with short options\n"
 chaos -c || echo -e "\nOK\n\n" && \
 chaos -c tests/everything.kaos -o || echo -e "\nOK\n\n" && \
 chaos -o everything || echo -e "\nOK\n\n" && \
 chaos -c tests/everything.kaos -o everything -e || echo -e "\nOK\n\n" && \
+chaos -O 7 tests/everything.kaos || echo -e "\nOK\n\n" && \
+chaos -O foo tests/everything.kaos || echo -e "\nOK\n\n" && \
 
 echo -e "\nINFO: Test other erroring arguments\n"
 chaos --no_such_arg || \
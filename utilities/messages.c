@@ -272,9 +272,30 @@ unsigned char help_txt[] = {
     0x20, 0x69, 0x6e, 0x20, 0x4a, 0x53, 0x4f, 0x4e, 0x20, 0x66, 0x6f, 0x72,
     0x6d, 0x61, 0x74, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x65, 0x78, 0x69, 0x74,
     0x20, 0x69, 0x6d, 0x6d, 0x65, 0x64, 0x69, 0x61, 0x74, 0x65, 0x6c, 0x79,
-    0x2e, 0x0a, 0x0a
+    0x2e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x74, 0x2c, 0x20, 0x2d, 0x2d,
+    0x74, 0x69, 0x65, 0x72, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x53, 0x65, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x65, 0x78,
+    0x65, 0x63, 0x75, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x74, 0x69, 0x65, 0x72,
+    0x2e, 0x20, 0x5b, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x70, 0x72, 0x65, 0x74,
+    0x65, 0x72, 0x2c, 0x20, 0x6a, 0x69, 0x74, 0x2c, 0x20, 0x74, 0x69, 0x65,
+    0x72, 0x65, 0x64, 0x5d, 0x20, 0x28, 0x64, 0x65, 0x66, 0x61, 0x75, 0x6c,
+    0x74, 0x3a, 0x20, 0x6a, 0x69, 0x74, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20,
+    0x2d, 0x67, 0x2c, 0x20, 0x2d, 0x2d, 0x67, 0x63, 0x2d, 0x73, 0x74, 0x61,
+    0x74, 0x73, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x50, 0x72, 0x69, 0x6e,
+    0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x67, 0x61, 0x72, 0x62, 0x61, 0x67,
+    0x65, 0x20, 0x63, 0x6f, 0x6c, 0x6c, 0x65, 0x63, 0x74, 0x6f, 0x72, 0x20,
+    0x73, 0x74, 0x61, 0x74, 0x69, 0x73, 0x74, 0x69, 0x63, 0x73, 0x20, 0x77,
+    0x68, 0x65, 0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x72, 0x6f, 0x67,
+    0x72, 0x61, 0x6d, 0x20, 0x65, 0x6e, 0x64, 0x73, 0x2e, 0x0a, 0x20, 0x20,
+    0x20, 0x20, 0x2d, 0x4f, 0x2c, 0x20, 0x2d, 0x2d, 0x6f, 0x70, 0x74, 0x69,
+    0x6d, 0x69, 0x7a, 0x65, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x53, 0x65,
+    0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6f, 0x70, 0x74, 0x69, 0x6d, 0x69,
+    0x7a, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x6c, 0x65, 0x76, 0x65, 0x6c,
+    0x2e, 0x20, 0x5b, 0x30, 0x2c, 0x20, 0x31, 0x2c, 0x20, 0x32, 0x5d, 0x20,
+    0x28, 0x64, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x3a, 0x20, 0x31, 0x29,
+    0x0a, 0x0a
 };
-unsigned int help_txt_len = 663;
+unsigned int help_txt_len = 914;
 
 void print_help() {
     char lang[__KAOS_MSG_LINE_LENGTH__];
@@ -21,6 +21,12 @@
  */
 
 #include "cpu.h"
+#include "tier0.h"
+#include "simd.h"
+#include "../interpreter/errors.h"
+
+extern i64 simd_result_cell[2];
+extern i64 ast_ref;
 
 typedef long (*plfv)();
 struct jit *_jit;
@@ -30,6 +36,8 @@ jit_op *skip_data;
 
 jit_label_array* label_array = NULL;
 jit_op_array* op_array = NULL;
+jit_function_table* function_table = NULL;
+cpu* running_cpu = NULL;
 
 char *reg_names[] = {
     "R0", "R1", "R2",  "R3",  "R4",  "R5",  "R6",  "R7",
@@ -42,6 +50,16 @@ i64 ast_stack_p = 0;
 bool temp_disable_debug = false;
 bool break_current_loop = false;
 
+i64* intern_table = NULL;
+size_t intern_table_capacity = 0;
+size_t intern_table_count = 0;
+
+// The unboxed list elements are handed out in this cell, it's only valid until the next access
+i64 list_element_cell[2];
+
+// The characters of the strings are handed out as these constant strings instead of new allocations
+cpu_char_string cpu_char_strings[CPU_CHAR_STRING_COUNT];
+
 cpu *new_cpu(KaosIR* program, unsigned short debug_level)
 {
     cpu *c = malloc(sizeof(cpu));
@@ -49,7 +67,12 @@ cpu *new_cpu(KaosIR* program, unsigned short debug_level)
     c->ic = 0;
     c->debug_level = debug_level;
 
-    c->stack = (int*)malloc(USHRT_MAX * 256 * sizeof(int));
+    c->stack = NULL;
+    c->stack_capacity = 0;
+    c->lazy_jit = false;
+    c->tier = CPU_TIER_JIT;
+    c->gc_stats = false;
+    cpu_init_char_strings();
 
     // ast_stack = (i64*)malloc(USHRT_MAX * 256 * sizeof(i64));
     return c;
@@ -57,13 +80,47 @@ cpu *new_cpu(KaosIR* program, unsigned short debug_level)
 
 void free_cpu(cpu *c)
 {
+    free(c->stack);
     free(c);
 }
 
+void grow_cpu_stack(cpu *c, i64 i)
+{
+    if (i < c->stack_capacity)
+        return;
+
+    i64 capacity = c->stack_capacity == 0 ? CPU_STACK_INITIAL_CAPACITY : c->stack_capacity;
+    while (capacity <= i)
+        capacity *= 2;
+    c->stack = (int*)realloc(c->stack, capacity * sizeof(int));
+    c->stack_capacity = capacity;
+}
+
 void run_cpu(cpu *c)
 {
+    // The frames of the JIT-compiled and the interpreted functions are all below this one
+    i64 stack_base = 0;
+    gc_set_stack_base(&stack_base);
+    gc_add_root(list_element_cell, sizeof(list_element_cell));
+    gc_add_root(simd_result_cell, sizeof(simd_result_cell));
+
     label_array = init_label_array();
     op_array = init_op_array();
+    running_cpu = c;
+
+    // Only the main function is lowered upfront, the others are lowered on their first call
+    if (c->lazy_jit) {
+        function_table = init_function_table(c->program);
+        c->ic = function_table->main_start;
+
+        // The main function is interpreted too, unless the JIT tier is forced
+        if (c->tier != CPU_TIER_JIT) {
+            tier0_run_main(c);
+            gc_set_stack_base(NULL);
+            return;
+        }
+    }
+
     _jit = jit_init();
 
     // jit_declare_arg(_jit, JIT_SIGNED_NUM, sizeof(long));
@@ -93,6 +150,7 @@ void run_cpu(cpu *c)
     }
 
     _main();
+    gc_set_stack_base(NULL);
 }
 
 void eat_until_hlt(cpu *c)
@@ -103,7 +161,7 @@ void eat_until_hlt(cpu *c)
 
 void fetch(cpu *c)
 {
-    c->inst = c->program->arr[c->ic++];
+    c->inst = &c->program->arr[c->ic++];
 }
 
 void execute(cpu *c)
@@ -115,13 +173,13 @@ void execute(cpu *c)
     // declare_label
     case DECLARE_LABEL: {
         jit_label* __f = jit_get_label(_jit);
-        push_label(label_array, __f);
+        set_label(label_array, c->inst->op1.value.i, __f);
         break;
     }
     // prolog
     case PROLOG: {
         jit_label* __f = jit_get_label(_jit);
-        label_array->arr[c->inst->op1->value.i] = __f;
+        set_label(label_array, c->inst->op1.value.i, __f);
         jit_prolog(_jit, &_f);
         break;
     }
@@ -147,239 +205,314 @@ void execute(cpu *c)
         break;
     // declare_arg
     case DECLARE_ARG:
-        jit_declare_arg(_jit, c->inst->op1->value.i, c->inst->op2->value.i);
+        jit_declare_arg(_jit, c->inst->op1.value.i, c->inst->op2.value.i);
         break;
     // getarg
     case GETARG:
-        jit_getarg(_jit, R(c->inst->op1->reg), c->inst->op2->value.i);
+        jit_getarg(_jit, R(c->inst->op1.reg), c->inst->op2.value.i);
         break;
     // ret
     case RETR:
-        jit_retr(_jit, R(c->inst->op1->reg));
+        jit_retr(_jit, R(c->inst->op1.reg));
         break;
     case RETI:
-        jit_reti(_jit, c->inst->op1->value.i);
+        jit_reti(_jit, c->inst->op1.value.i);
         break;
     // >>> Function Calls <<<
     // prepare
     case PREPARE:
         temp_disable_debug = true;
+        if (c->lazy_jit)
+            load_call_target(c);
         jit_prepare(_jit);
         break;
     // putarg
     case PUTARGR:
-        jit_putargr(_jit, R(c->inst->op1->reg));
+        jit_putargr(_jit, R(c->inst->op1.reg));
         break;
     case PUTARGI:
-        jit_putargi(_jit, c->inst->op1->value.i);
+        jit_putargi(_jit, c->inst->op1.value.i);
         break;
     // retval
     case RETVAL:
-        jit_retval(_jit, R(c->inst->op1->reg));
+        jit_retval(_jit, R(c->inst->op1.reg));
         break;
     // call
     case CALLR:
-        jit_callr(_jit, R(c->inst->op1->reg));
+        jit_callr(_jit, R(c->inst->op1.reg));
         break;
     case CALL: {
-        jit_op* __op = jit_call(_jit, label_array->arr[c->inst->op1->value.i]);
-        push_op(op_array, __op);
+        if (c->lazy_jit) {
+            jit_callr(_jit, R(CPU_CALL_TARGET_REGISTER));
+        } else {
+            jit_op* __op = jit_call(_jit, label_array->arr[c->inst->op1.value.i]);
+            set_op(op_array, c->inst->op2.value.i, __op);
+        }
         temp_disable_debug = false;
         break;
     }
     // >>> Transfer Operations <<<
     // mov
     case MOVR:
-        jit_movr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg));
+        jit_movr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg));
         break;
     case MOVI:
-        jit_movi(_jit, R(c->inst->op1->reg), c->inst->op2->value.i);
+        // String literals are referenced by their address in the constant data
+        if (c->inst->op2.value_type == IR_STRING)
+            jit_movi(_jit, R(c->inst->op1.reg), c->inst->op2.value.s);
+        else
+            jit_movi(_jit, R(c->inst->op1.reg), c->inst->op2.value.i);
         break;
     // fmov
     case FMOV:
-        jit_fmovi(_jit, FR(c->inst->op1->reg), c->inst->op2->value.f);
+        jit_fmovi(_jit, FR(c->inst->op1.reg), c->inst->op2.value.f);
         break;
     case FMOVR:
-        jit_fmovr(_jit, FR(c->inst->op1->reg), FR(c->inst->op2->reg));
+        jit_fmovr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg));
         break;
     // alloc
     case ALLOCAI: {
-        int i = jit_allocai(_jit, c->inst->op2->value.i);
-        c->stack[c->inst->op1->value.i] = i;
+        int i = jit_allocai(_jit, c->inst->op2.value.i);
+        grow_cpu_stack(c, c->inst->op1.value.i);
+        c->stack[c->inst->op1.value.i] = i;
         break;
     }
     case REF_ALLOCAI:
-        jit_addi(_jit, R(c->inst->op1->reg), R_FP, c->stack[c->inst->op2->value.i]);
+        jit_addi(_jit, R(c->inst->op1.reg), R_FP, c->stack[c->inst->op2.value.i]);
         break;
     // >>> Load Operations <<<
     // ldr
     case LDR:
-        jit_ldr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_ldr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     case LDXR:
-        jit_ldxr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg), c->inst->op4->value.i);
+        jit_ldxr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg), c->inst->op4.value.i);
+        break;
+    case LDXI:
+        jit_ldxi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i, c->inst->op4.value.i);
         break;
     // fldr
     case FLDR:
-        jit_fldr(_jit, FR(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_fldr(_jit, FR(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     case FLDXR:
-        jit_fldxr(_jit, FR(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg), c->inst->op4->value.i);
+        jit_fldxr(_jit, FR(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg), c->inst->op4.value.i);
+        break;
+    case FLDXI:
+        jit_fldxi(_jit, FR(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i, c->inst->op4.value.i);
         break;
     // >>> Store Operations <<<
     // str
     case STR:
-        jit_str(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_str(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     case STXR:
-        jit_stxr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg), c->inst->op4->value.i);
+        jit_stxr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg), c->inst->op4.value.i);
+        break;
+    case STXI:
+        jit_stxi(_jit, c->inst->op2.value.i, R(c->inst->op1.reg), R(c->inst->op3.reg), c->inst->op4.value.i);
         break;
     // fstr
     case FSTR:
-        jit_fstr(_jit, R(c->inst->op1->reg), FR(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_fstr(_jit, R(c->inst->op1.reg), FR(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     case FSTXR:
-        jit_fstxr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), FR(c->inst->op3->reg), c->inst->op4->value.i);
+        jit_fstxr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), FR(c->inst->op3.reg), c->inst->op4.value.i);
+        break;
+    case FSTXI:
+        jit_fstxi(_jit, c->inst->op2.value.i, R(c->inst->op1.reg), FR(c->inst->op3.reg), c->inst->op4.value.i);
         break;
     // >>> Binary Arithmetic Operations <<<
     // add
     case ADDR:
-        jit_addr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_addr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case ADDI:
-        jit_addi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_addi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // sub
     case SUBR:
-        jit_subr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_subr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case SUBI:
-        jit_subi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_subi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // mul
     case MULR:
-        jit_mulr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_mulr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case MULI:
-        jit_muli(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_muli(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // div
     case DIVR:
-        jit_divr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_divr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case DIVI:
-        jit_divi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_divi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // mod
     case MODR:
-        jit_modr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_modr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case MODI:
-        jit_modi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_modi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // Binary Logic
     // and
     case ANDR:
-        jit_andr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_andr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case ANDI:
-        jit_andi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_andi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // or
     case ORR:
-        jit_orr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_orr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case ORI:
-        jit_ori(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_ori(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // xor
     case XORR:
-        jit_xorr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_xorr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case XORI:
-        jit_xori(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_xori(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // Binary Shift
     // lsh
     case LSHR:
-        jit_lshr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_lshr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case LSHI:
-        jit_lshi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_lshi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
         break;
     // rsh
     case RSHR:
-        jit_rshr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_rshr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     case RSHI:
-        jit_rshi(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), c->inst->op3->value.i);
+        jit_rshi(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), c->inst->op3.value.i);
+        break;
+    // >>> Binary Floating-point Arithmetic Operations <<<
+    // fadd
+    case FADDR:
+        jit_faddr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg), FR(c->inst->op3.reg));
+        break;
+    // fsub
+    case FSUBR:
+        jit_fsubr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg), FR(c->inst->op3.reg));
+        break;
+    // fmul
+    case FMULR:
+        jit_fmulr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg), FR(c->inst->op3.reg));
+        break;
+    // fdiv
+    case FDIVR:
+        jit_fdivr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg), FR(c->inst->op3.reg));
         break;
     // >>> Unary Arithmetic Operations <<<
     // negr
     case NEGR:
-        jit_negr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg));
+        jit_negr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg));
         break;
     // fnegr
     case FNEGR:
-        jit_fnegr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg));
+        jit_fnegr(_jit, FR(c->inst->op1.reg), FR(c->inst->op2.reg));
         break;
     // notr
     case NOTR:
-        jit_notr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg));
+        jit_notr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg));
         break;
     // >>> Compare Instructions <<<
     // eqr
     case EQR:
-        jit_eqr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_eqr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     // ner
     case NER:
-        jit_ner(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_ner(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     // gtr
     case GTR:
-        jit_gtr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_gtr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     // ltr
     case LTR:
-        jit_ltr(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_ltr(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     // ger
     case GER:
-        jit_ger(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_ger(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
     // ler
     case LER:
-        jit_ler(_jit, R(c->inst->op1->reg), R(c->inst->op2->reg), R(c->inst->op3->reg));
+        jit_ler(_jit, R(c->inst->op1.reg), R(c->inst->op2.reg), R(c->inst->op3.reg));
         break;
+    // feqr
+    case FEQR: {
+        FLOAT_COMPARISON(jit_fbeqr);
+        break;
+    }
+    // fner
+    case FNER: {
+        FLOAT_COMPARISON(jit_fbner);
+        break;
+    }
+    // fgtr
+    case FGTR: {
+        FLOAT_COMPARISON(jit_fbgtr);
+        break;
+    }
+    // fltr
+    case FLTR: {
+        FLOAT_COMPARISON(jit_fbltr);
+        break;
+    }
+    // fger
+    case FGER: {
+        FLOAT_COMPARISON(jit_fbger);
+        break;
+    }
+    // fler
+    case FLER: {
+        FLOAT_COMPARISON(jit_fbler);
+        break;
+    }
     // >>> Conversions <<<
     // extr
     case EXTR:
-        jit_extr(_jit, FR(c->inst->op1->reg), R(c->inst->op2->reg));
+        jit_extr(_jit, FR(c->inst->op1.reg), R(c->inst->op2.reg));
         break;
     // truncr
     case TRUNCR:
-        jit_truncr(_jit, R(c->inst->op1->reg), FR(c->inst->op2->reg));
+        jit_truncr(_jit, R(c->inst->op1.reg), FR(c->inst->op2.reg));
         break;
     // >>> Branch Operations & Jumps <<<
     // beq
     case BEQR: {
-        jit_op* __op = jit_beqr(_jit, JIT_FORWARD, R(c->inst->op1->reg), R(c->inst->op2->reg));
-        push_op(op_array, __op);
+        jit_op* __op = jit_beqr(_jit, JIT_FORWARD, R(c->inst->op1.reg), R(c->inst->op2.reg));
+        set_op(op_array, c->inst->op3.value.i, __op);
         break;
     }
     case BEQI: {
-        jit_op* __op = jit_beqi(_jit, JIT_FORWARD, R(c->inst->op1->reg), c->inst->op2->value.i);
-        push_op(op_array, __op);
+        jit_op* __op = jit_beqi(_jit, JIT_FORWARD, R(c->inst->op1.reg), c->inst->op2.value.i);
+        set_op(op_array, c->inst->op3.value.i, __op);
         break;
     }
     // jmpi
     case JMPI:
-        jit_jmpi(_jit, label_array->arr[c->inst->op1->value.i]);
+        jit_jmpi(_jit, label_array->arr[c->inst->op1.value.i]);
         break;
+    case JMPI_FORWARD: {
+        jit_op* __op = jit_jmpi(_jit, JIT_FORWARD);
+        set_op(op_array, c->inst->op1.value.i, __op);
+        break;
+    }
     // patch
     case PATCH:
-        jit_patch(_jit, op_array->arr[c->inst->op1->value.i]);
+        jit_patch(_jit, op_array->arr[c->inst->op1.value.i]);
         break;
     // >>> Non-Atomic Instructions <<<
     // Dynamic Instructions (prefixed with `DYN_`)
@@ -484,7 +617,7 @@ void execute(cpu *c)
     }
     // Dynamic Exit
     case DYN_EXIT: {
-        jit_movi(_jit, R(2), exit);
+        jit_movi(_jit, R(2), cpu_exit);
         jit_prepare(_jit);
         jit_putargr(_jit, R(1));
         jit_callr(_jit, R(2));
@@ -534,11 +667,12 @@ void execute(cpu *c)
         break;
     }
     case DYN_COMP_ACCESS: {
-        jit_movi(_jit, R(2), cpu_composite_access);
+        jit_movi(_jit, R(2), cpu_composite_element);
         jit_prepare(_jit);
-        jit_putargr(_jit, R(c->inst->op1->reg));
-        jit_putargr(_jit, R(c->inst->op2->reg));
-        jit_putargr(_jit, R(c->inst->op3->reg));
+        jit_putargi(_jit, (i64)c->inst->ast);
+        jit_putargr(_jit, R(c->inst->op1.reg));
+        jit_putargr(_jit, R(c->inst->op2.reg));
+        jit_putargr(_jit, R(c->inst->op3.reg));
         jit_callr(_jit, R(2));
         jit_retval(_jit, R(2));
         break;
@@ -604,29 +738,115 @@ void execute(cpu *c)
         jit_retval(_jit, R(1));
         break;
     }
+    // Dynamic Grow List
+    case DYN_LIST_APPEND: {
+        jit_movi(_jit, R(3), cpu_list_append);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(12));
+        jit_putargr(_jit, R(0));
+        jit_putargr(_jit, R(1));
+        jit_fputargr(_jit, FR(1), sizeof(double));
+        jit_callr(_jit, R(3));
+        break;
+    }
+    case DYN_LIST_EXTEND: {
+        jit_movi(_jit, R(3), cpu_list_extend);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(12));
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(3));
+        break;
+    }
+    case DYN_LIST_INSERT: {
+        jit_movi(_jit, R(3), cpu_list_insert);
+        jit_prepare(_jit);
+        jit_putargi(_jit, (i64)c->inst->ast);
+        jit_putargr(_jit, R(12));
+        jit_putargr(_jit, R(13));
+        jit_putargr(_jit, R(0));
+        jit_putargr(_jit, R(1));
+        jit_fputargr(_jit, FR(1), sizeof(double));
+        jit_callr(_jit, R(3));
+        break;
+    }
+    // Dynamic Vectorized List Kernels
+    case DYN_LIST_KERNEL: {
+        jit_movi(_jit, R(3), simd_run_kernel);
+        jit_prepare(_jit);
+        jit_putargi(_jit, c->inst->op1.value.i);
+        jit_putargi(_jit, (i64)c->inst->ast);
+        jit_putargr(_jit, R(12));
+        jit_putargr(_jit, R(0));
+        jit_putargr(_jit, R(1));
+        jit_fputargr(_jit, FR(1), sizeof(double));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(2));
+        break;
+    }
     // Dynamic Composite Helpers
     case DYN_GET_COMP_SIZE: {
         jit_movi(_jit, R(3), cpu_get_composite_len);
         jit_prepare(_jit);
-        jit_putargr(_jit, R(c->inst->op2->reg));
+        jit_putargr(_jit, R(c->inst->op2.reg));
         jit_callr(_jit, R(3));
-        jit_retval(_jit, R(c->inst->op1->reg));
+        jit_retval(_jit, R(c->inst->op1.reg));
         break;
     }
-    // Dynamic Loop Break
-    case DYN_BREAK: {
-        jit_movi(_jit, R(2), cpu_set_break_current_loop);
+    case DYN_COMP_SHARE: {
+        jit_movi(_jit, R(3), cpu_composite_share);
         jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1.reg));
+        jit_putargr(_jit, R(c->inst->op2.reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op2.reg));
+        break;
+    }
+    case DYN_COMP_UNSHARE: {
+        jit_movi(_jit, R(3), cpu_composite_unshare);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1.reg));
+        jit_putargr(_jit, R(c->inst->op2.reg));
+        jit_callr(_jit, R(3));
+        jit_retval(_jit, R(c->inst->op2.reg));
+        break;
+    }
+    case DYN_COMP_UNSHARE_ELEMENT: {
+        jit_movi(_jit, R(2), cpu_composite_unshare_element);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(c->inst->op1.reg));
+        jit_putargr(_jit, R(c->inst->op2.reg));
+        jit_putargr(_jit, R(c->inst->op3.reg));
         jit_callr(_jit, R(2));
         break;
     }
-    case DYN_BREAK_HANDLE: {
-        jit_movi(_jit, R(2), cpu_get_break_current_loop);
+    // Dynamic String Helpers
+    case DYN_STR_UNSHARE: {
+        jit_movi(_jit, R(2), cpu_string_unshare);
+        jit_prepare(_jit);
+        jit_putargr(_jit, R(1));
+        jit_callr(_jit, R(2));
+        jit_retval(_jit, R(1));
+        break;
+    }
+    case DYN_STR_APPEND: {
+        jit_movi(_jit, R(2), cpu_string_append);
         jit_prepare(_jit);
+        jit_putargr(_jit, R(1));
+        jit_putargr(_jit, R(5));
         jit_callr(_jit, R(2));
         jit_retval(_jit, R(1));
         break;
     }
+    // Dynamic Loop Break
+    case DYN_BREAK: {
+        jit_movi(_jit, R(3), c->inst->op1.value.i);
+        jit_sti(_jit, &break_current_loop, R(3), sizeof(bool));
+        break;
+    }
+    case DYN_BREAK_HANDLE: {
+        jit_ldi(_jit, R(c->inst->op1.reg), &break_current_loop, sizeof(bool));
+        break;
+    }
     // Debug
     case DEBUG:
         debug(_jit);
@@ -648,14 +868,17 @@ jit_label_array* init_label_array()
     return label_array;
 }
 
-void push_label(jit_label_array* label_array, jit_label* label)
+void set_label(jit_label_array* label_array, i64 i, jit_label* label)
 {
-    if (label_array->capacity == 0) {
-        label_array->arr = (jit_label**)malloc((++label_array->capacity) * sizeof(jit_label*));
-    } else {
-        label_array->arr = (jit_label**)realloc(label_array->arr, (++label_array->capacity) * sizeof(jit_label*));
+    // The labels are set by their IDs since the functions might be lowered out of order
+    if (i >= label_array->capacity) {
+        while (label_array->capacity <= i)
+            label_array->capacity = label_array->capacity == 0 ? 1 : label_array->capacity * 2;
+        label_array->arr = (jit_label**)realloc(label_array->arr, label_array->capacity * sizeof(jit_label*));
     }
-    label_array->arr[label_array->size++] = label;
+    label_array->arr[i] = label;
+    if (i >= label_array->size)
+        label_array->size = i + 1;
 }
 
 jit_label* get_label(jit_label_array* label_array, i64 i)
@@ -672,14 +895,17 @@ jit_op_array* init_op_array()
     return op_array;
 }
 
-void push_op(jit_op_array* op_array, jit_op* op)
+void set_op(jit_op_array* op_array, i64 i, jit_op* op)
 {
-    if (op_array->capacity == 0) {
-        op_array->arr = (jit_op**)malloc((++op_array->capacity) * sizeof(jit_op*));
-    } else {
-        op_array->arr = (jit_op**)realloc(op_array->arr, (++op_array->capacity) * sizeof(jit_op*));
+    // The ops are set by their IDs since the functions might be lowered out of order
+    if (i >= op_array->capacity) {
+        while (op_array->capacity <= i)
+            op_array->capacity = op_array->capacity == 0 ? 1 : op_array->capacity * 2;
+        op_array->arr = (jit_op**)realloc(op_array->arr, op_array->capacity * sizeof(jit_op*));
     }
-    op_array->arr[op_array->size++] = op;
+    op_array->arr[i] = op;
+    if (i >= op_array->size)
+        op_array->size = i + 1;
 }
 
 jit_op* get_op(jit_op_array* op_array, i64 i)
@@ -687,6 +913,113 @@ jit_op* get_op(jit_op_array* op_array, i64 i)
     return op_array->arr[i];
 }
 
+jit_function_table* init_function_table(KaosIR* program)
+{
+    jit_function_table* function_table = malloc(sizeof *function_table);
+    function_table->arr = NULL;
+    function_table->size = 0;
+    function_table->main_start = 0;
+
+    for (i64 i = 0; i < program->size; i++) {
+        KaosInst* inst = &program->arr[i];
+        if (inst->op_code == MAIN_PROLOG)
+            function_table->main_start = i;
+        if (inst->op_code != PROLOG)
+            continue;
+
+        i64 label = inst->op1.value.i;
+        if (label >= function_table->size) {
+            function_table->arr = realloc(function_table->arr, (label + 1) * sizeof(jit_function));
+            for (i64 j = function_table->size; j <= label; j++) {
+                function_table->arr[j].start = -1;
+                function_table->arr[j].end = -1;
+                function_table->arr[j].jit = NULL;
+                function_table->arr[j].code = NULL;
+                function_table->arr[j].tier0 = NULL;
+                function_table->arr[j].call_count = 0;
+                function_table->arr[j].back_edge_count = 0;
+            }
+            function_table->size = label + 1;
+        }
+
+        // A function ends where the next one starts, the patches in between belong to the calls to the next one
+        i64 end = i + 1;
+        while (
+            end < program->size
+            &&
+            program->arr[end].op_code != PROLOG
+            &&
+            program->arr[end].op_code != MAIN_PROLOG
+            &&
+            program->arr[end].op_code != HLT
+        )
+            end++;
+        while (program->arr[end - 1].op_code == PATCH)
+            end--;
+
+        function_table->arr[label].start = i;
+        function_table->arr[label].end = end;
+    }
+
+    return function_table;
+}
+
+void load_call_target(cpu *c)
+{
+    // Look ahead for the function that is called after its arguments are put
+    i64 ic = c->ic;
+    while (c->program->arr[ic].op_code != CALL)
+        ic++;
+    i64 label = c->program->arr[ic].op1.value.i;
+    jit_function* function = &function_table->arr[label];
+
+    // Compile the function if it's the first call to it
+    jit_ldi(_jit, R(CPU_CALL_TARGET_REGISTER), &function->code, sizeof(void*));
+    jit_op* is_compiled = jit_bnei(_jit, JIT_FORWARD, R(CPU_CALL_TARGET_REGISTER), 0);
+    jit_movi(_jit, R(CPU_CALL_TARGET_REGISTER), cpu_compile_function);
+    jit_prepare(_jit);
+    jit_putargi(_jit, label);
+    jit_callr(_jit, R(CPU_CALL_TARGET_REGISTER));
+    jit_retval(_jit, R(CPU_CALL_TARGET_REGISTER));
+    jit_patch(_jit, is_compiled);
+}
+
+i64 cpu_compile_function(i64 label)
+{
+    jit_function* function = &function_table->arr[label];
+    if (function->code != NULL)
+        return (i64)function->code;
+
+    // Lower the function into a JIT context of its own
+    struct jit* jit_backup = _jit;
+    i64 ic_backup = running_cpu->ic;
+    KaosInst* inst_backup = running_cpu->inst;
+
+    _jit = jit_init();
+    running_cpu->ic = function->start;
+    while (running_cpu->ic < function->end) {
+        fetch(running_cpu);
+        execute(running_cpu);
+    }
+    jit_generate_code(_jit);
+    function->jit = _jit;
+    function->code = _f;
+
+    _jit = jit_backup;
+    running_cpu->ic = ic_backup;
+    running_cpu->inst = inst_backup;
+
+    return (i64)function->code;
+}
+
+void cpu_exit(i64 status)
+{
+    // The exit statement leaves without returning to the parser, the statistics are printed here instead
+    if (running_cpu->gc_stats)
+        gc_print_stats();
+    exit(status);
+}
+
 void cpu_dyn_print(i64 newline, i64 pretty)
 {
     jit_movi(_jit, R(3), cpu_print);
@@ -701,11 +1034,6 @@ void cpu_dyn_print(i64 newline, i64 pretty)
 
 void cpu_print(i64 r0, i64 r1, f64 fr1, i64 nl, i64 pretty)
 {
-    // Disable printing if we're breaking from a loop.
-    // TODO: Not sure if it's the best solution.
-    if (break_current_loop)
-        return;
-
     switch (r0) {
     case V_BOOL:
         cpu_print_bool(r1);
@@ -791,7 +1119,8 @@ void cpu_print_flex(i64 addr, i64 pretty, unsigned long iter)
 void cpu_print_list(i64 addr, i64 pretty, unsigned long iter)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    i64 element_type = *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    addr = (i64)cpu_list_elements(addr);
     printf("[");
     if (pretty)
         printf("\n");
@@ -801,7 +1130,12 @@ void cpu_print_list(i64 addr, i64 pretty, unsigned long iter)
             for (unsigned long j = 0; j < iter; j++) {
                 printf(__KAOS_TAB__);
             }
-        cpu_print_flex(*(i64*)addr, pretty, iter);
+        if (element_type == V_ANY) {
+            cpu_print_flex(*(i64*)addr, pretty, iter);
+        } else {
+            i64 element[2] = {element_type, *(i64*)addr};
+            cpu_print_flex((i64)element, pretty, iter);
+        }
         addr += sizeof(long long);
         if (i + 1 != *len) {
             if (pretty)
@@ -823,7 +1157,7 @@ void cpu_print_list(i64 addr, i64 pretty, unsigned long iter)
 void cpu_print_dict(i64 addr, i64 pretty, unsigned long iter)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    addr += CPU_DICT_ENTRIES_OFFSET;
     printf("{");
     if (pretty)
         printf("\n");
@@ -866,16 +1200,33 @@ i64 cpu_composite_access(i64 addr, i64 type, i64 val)
         return cpu_dict_key_search(addr, val);
 }
 
+i64 cpu_composite_element(i64 ast, i64 addr, i64 type, i64 val)
+{
+    i64 element = cpu_composite_access(addr, type, val);
+    if (element == 0 && type == V_DICT) {
+        ast_ref = ast;
+        throw_error(E_UNDEFINED_DICT_KEY, (char*)(val + sizeof(size_t)));
+    }
+    return element;
+}
+
 i64 cpu_list_index_access(i64 addr, i64 i)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    i64 element_type = *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    addr = (i64)cpu_list_elements(addr);
     if (i < 0)
         i = *len + i;
     // printf("len: %lu\n", *len);
     // printf("i: %lld\n", i);
 
     addr += sizeof(long long) * i;
+    if (element_type != V_ANY) {
+        list_element_cell[0] = element_type;
+        list_element_cell[1] = *(i64*)addr;
+        return (i64)list_element_cell;
+    }
+
     i64 _addr = *(i64*)addr;
     // i64 type = *(i64*)_addr;
     // _addr += sizeof(long long);
@@ -888,32 +1239,328 @@ i64 cpu_list_index_access(i64 addr, i64 i)
     return _addr;
 }
 
+i64* cpu_list_elements(i64 addr)
+{
+    return *(i64**)(addr + CPU_LIST_ELEMENTS_OFFSET);
+}
+
+void cpu_list_reserve(i64 addr, size_t capacity)
+{
+    size_t* len = (size_t*)addr;
+    size_t* old_capacity = (size_t*)(addr + CPU_LIST_CAPACITY_OFFSET);
+    if (capacity <= *old_capacity)
+        return;
+
+    // Grow geometrically so that a series of appends is amortized O(1)
+    size_t new_capacity = *old_capacity < CPU_LIST_MIN_CAPACITY ? CPU_LIST_MIN_CAPACITY : *old_capacity;
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+
+    i64** elements = (i64**)(addr + CPU_LIST_ELEMENTS_OFFSET);
+    if ((i64)*elements == addr + CPU_LIST_HEADER_SIZE) {
+        // The inline storage is a part of the list's own block, it can't be reallocated
+        i64* new_elements = (i64*)gc_alloc(new_capacity * sizeof(i64));
+        memcpy(new_elements, *elements, *len * sizeof(i64));
+        *elements = new_elements;
+    } else {
+        *elements = (i64*)gc_realloc(*elements, new_capacity * sizeof(i64));
+    }
+    *old_capacity = new_capacity;
+}
+
+void cpu_list_box(i64 addr)
+{
+    size_t* len = (size_t*)addr;
+    i64* element_type = (i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    i64* elements = cpu_list_elements(addr);
+    // The list owns its raw strings so the refs can take them over
+    for (size_t i = 0; i < *len; i++)
+        elements[i] = cpu_new_common(*element_type, elements[i]);
+    *element_type = V_ANY;
+}
+
+i64 cpu_list_prepare_element(i64 addr, i64 type, i64 val)
+{
+    size_t* len = (size_t*)addr;
+    i64* element_type = (i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+
+    // An empty list takes the type of its first element
+    if (*element_type == V_ANY && *len == 0 && CPU_LIST_IS_UNBOXED_TYPE(type))
+        *element_type = type;
+    else if (*element_type != V_ANY && *element_type != type)
+        cpu_list_box(addr);
+
+    if (*element_type == V_ANY)
+        return cpu_new_element(type, val);
+    return cpu_new_unboxed_element(type, val);
+}
+
+void cpu_list_append(i64 addr, i64 r0, i64 r1, f64 fr1)
+{
+    if (r0 == V_FLOAT)
+        memcpy(&r1, &fr1, sizeof(f64));
+    // Copy the element first, it might be the list itself
+    i64 element = cpu_list_prepare_element(addr, r0, r1);
+
+    size_t* len = (size_t*)addr;
+    cpu_list_reserve(addr, *len + 1);
+    cpu_list_elements(addr)[*len] = element;
+    *len += 1;
+}
+
+void cpu_list_extend(i64 addr, i64 other_addr)
+{
+    size_t* len = (size_t*)addr;
+    size_t other_len = *(size_t*)other_addr;
+    cpu_list_reserve(addr, *len + other_len);
+
+    // A list can extend itself, so only its original length is copied
+    for (size_t i = 0; i < other_len; i++) {
+        i64 element = cpu_list_index_access(other_addr, i);
+        i64 type = *(i64*)element;
+        element += sizeof(i64);
+        cpu_list_append(addr, type, *(i64*)element, *(f64*)element);
+    }
+}
+
+void cpu_list_insert(i64 ast, i64 addr, i64 i, i64 r0, i64 r1, f64 fr1)
+{
+    size_t* len = (size_t*)addr;
+    i64 index = i;
+    if (i < 0)
+        i = *len + i;
+
+    // An element can be inserted in front of any of the elements or after the last one
+    if (i < 0 || i > (i64)*len) {
+        ast_ref = ast;
+        throw_error(E_INDEX_OUT_OF_RANGE, NULL, NULL, index);
+    }
+
+    if (r0 == V_FLOAT)
+        memcpy(&r1, &fr1, sizeof(f64));
+    i64 element = cpu_list_prepare_element(addr, r0, r1);
+
+    cpu_list_reserve(addr, *len + 1);
+    i64* elements = cpu_list_elements(addr);
+    memmove(&elements[i + 1], &elements[i], (*len - (size_t)i) * sizeof(i64));
+    elements[i] = element;
+    *len += 1;
+}
+
 i64 cpu_dict_key_search(i64 addr, i64 search_key_addr)
+{
+    i64 key_value_pair = cpu_dict_find_entry(addr, search_key_addr);
+
+    // TODO: throw error
+    if (key_value_pair == 0)
+        return 0;
+
+    key_value_pair += sizeof(i64);
+    return *(i64*)key_value_pair;
+}
+
+u64 cpu_string_hash(char* s)
+{
+    // FNV-1a
+    u64 hash = 14695981039346656037ULL;
+    for (; *s != '\0'; s++) {
+        hash ^= (unsigned char)*s;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+u64 cpu_string_get_hash(i64 addr)
+{
+    cpu_string_header* header = CPU_STRING_HEADER(addr);
+    if (!(header->flags & CPU_STRING_HASHED)) {
+        header->hash = cpu_string_hash((char*)(addr + sizeof(size_t)));
+        header->flags |= CPU_STRING_HASHED;
+    }
+    return header->hash;
+}
+
+bool cpu_string_equals(i64 addr1, i64 addr2)
+{
+    if (addr1 == addr2)
+        return true;
+
+    cpu_string_header* header1 = CPU_STRING_HEADER(addr1);
+    cpu_string_header* header2 = CPU_STRING_HEADER(addr2);
+    if ((header1->flags & CPU_STRING_INTERNED) && (header2->flags & CPU_STRING_INTERNED))
+        return false;
+    if ((header1->flags & CPU_STRING_HASHED) && (header2->flags & CPU_STRING_HASHED) && header1->hash != header2->hash)
+        return false;
+
+    return strcmp((char*)(addr1 + sizeof(size_t)), (char*)(addr2 + sizeof(size_t))) == 0;
+}
+
+i64 cpu_string_alloc(size_t len)
+{
+    cpu_string_header* header = gc_alloc_atomic(sizeof(cpu_string_header) + sizeof(size_t) + (len + 1) * sizeof(char));
+    header->hash = 0;
+    header->flags = 0;
+
+    i64 addr = (i64)(header + 1);
+    size_t* p_t = (size_t*)addr;
+    *p_t = len;
+    return addr;
+}
+
+i64 cpu_string_intern(i64 addr)
+{
+    cpu_string_header* header = CPU_STRING_HEADER(addr);
+    if (header->flags & CPU_STRING_INTERNED)
+        return addr;
+
+    u64 hash = cpu_string_get_hash(addr);
+    char* s = (char*)(addr + sizeof(size_t));
+    if (intern_table != NULL) {
+        size_t mask = intern_table_capacity - 1;
+        for (size_t i = hash & mask; intern_table[i] != 0; i = (i + 1) & mask) {
+            i64 interned = intern_table[i];
+            if (CPU_STRING_HEADER(interned)->hash == hash && strcmp(s, (char*)(interned + sizeof(size_t))) == 0)
+                return interned;
+        }
+    }
+
+    // The constant strings never change so they are interned in-place, the others are copied
+    i64 interned = addr;
+    if (!(header->flags & CPU_STRING_CONSTANT)) {
+        size_t len = strlen(s);
+        interned = cpu_string_alloc(len);
+        memcpy((void*)(interned + sizeof(size_t)), s, (len + 1) * sizeof(char));
+        CPU_STRING_HEADER(interned)->hash = hash;
+        CPU_STRING_HEADER(interned)->flags = CPU_STRING_HASHED;
+    }
+
+    CPU_STRING_HEADER(interned)->flags |= CPU_STRING_INTERNED;
+    cpu_intern_table_insert(interned);
+    return interned;
+}
+
+void cpu_intern_table_insert(i64 addr)
+{
+    // Keep the load factor under a half so the probe sequences stay short
+    if ((intern_table_count + 1) * 2 > intern_table_capacity) {
+        i64* old_table = intern_table;
+        size_t old_capacity = intern_table_capacity;
+
+        intern_table_capacity = old_capacity == 0 ? CPU_INTERN_TABLE_INITIAL_CAPACITY : old_capacity * 2;
+        intern_table = calloc(intern_table_capacity, sizeof(i64));
+        intern_table_count = 0;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_table[i] != 0)
+                cpu_intern_table_insert(old_table[i]);
+        }
+        free(old_table);
+    }
+
+    size_t mask = intern_table_capacity - 1;
+    size_t i = CPU_STRING_HEADER(addr)->hash & mask;
+    while (intern_table[i] != 0)
+        i = (i + 1) & mask;
+    intern_table[i] = addr;
+    intern_table_count++;
+}
+
+void cpu_intern_table_prune()
+{
+    if (intern_table == NULL)
+        return;
+
+    // Rehash the strings that survived the collection, the probe sequences can't have holes
+    i64* old_table = intern_table;
+    intern_table = calloc(intern_table_capacity, sizeof(i64));
+    intern_table_count = 0;
+    for (size_t i = 0; i < intern_table_capacity; i++) {
+        if (old_table[i] != 0 && gc_is_live(old_table[i]))
+            cpu_intern_table_insert(old_table[i]);
+    }
+    free(old_table);
+}
+
+i64 cpu_dict_entry_key(i64 key_value_pair)
+{
+    i64 key_ref = *(i64*)key_value_pair;
+    key_ref += sizeof(i64);
+    return *(i64*)key_ref;
+}
+
+cpu_dict_index* cpu_dict_get_index(i64 addr)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    cpu_dict_index** index_ref = (cpu_dict_index**)(addr + CPU_DICT_INDEX_OFFSET);
+    if (*index_ref != NULL || *len <= CPU_DICT_LINEAR_SCAN_LIMIT)
+        return *index_ref;
 
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
+    // Keep the load factor under a half so the probe sequences stay short
+    size_t capacity = 1;
+    while (capacity < *len * 2)
+        capacity <<= 1;
 
+    cpu_dict_index* index = gc_alloc(sizeof(cpu_dict_index) + capacity * sizeof(cpu_dict_slot));
+    index->capacity = capacity;
+
+    i64* entries = (i64*)(addr + CPU_DICT_ENTRIES_OFFSET);
     for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
+        // Intern the keys so they are compared by their addresses from now on
+        i64 key_ref = *(i64*)entries[i];
+        key_ref += sizeof(i64);
+        i64 key = cpu_string_intern(*(i64*)key_ref);
+        *(i64*)key_ref = key;
 
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
-        i64 value_ref = *(i64*)key_value_pair;
+        u64 hash = cpu_string_get_hash(key);
+        cpu_dict_slot* slot = cpu_dict_find_slot(index, hash, key);
 
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
+        // The first one of the duplicate keys wins, same as the linear scan
+        if (slot->key_value_pair != 0)
+            continue;
 
-        if (strcmp(search_key, key) == 0)
-            return value_ref;
+        slot->hash = hash;
+        slot->key_value_pair = entries[i];
     }
 
-    // TODO: throw error
+    *index_ref = index;
+    return index;
+}
+
+cpu_dict_slot* cpu_dict_find_slot(cpu_dict_index* index, u64 hash, i64 search_key_addr)
+{
+    size_t mask = index->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        cpu_dict_slot* slot = &index->slots[i];
+        if (slot->key_value_pair == 0)
+            return slot;
+
+        // Compare the cached hashes before the keys themselves
+        if (
+            slot->key_value_pair != CPU_DICT_TOMBSTONE
+            &&
+            slot->hash == hash
+            &&
+            cpu_string_equals(search_key_addr, cpu_dict_entry_key(slot->key_value_pair))
+        )
+            return slot;
+    }
+}
+
+i64 cpu_dict_find_entry(i64 addr, i64 search_key_addr)
+{
+    // The constant keys are interned in-place, so the lookups with them compare the addresses only
+    if (CPU_STRING_HEADER(search_key_addr)->flags & CPU_STRING_CONSTANT)
+        search_key_addr = cpu_string_intern(search_key_addr);
+
+    cpu_dict_index* index = cpu_dict_get_index(addr);
+    if (index != NULL)
+        return cpu_dict_find_slot(index, cpu_string_get_hash(search_key_addr), search_key_addr)->key_value_pair;
+
+    size_t* len = (size_t*)addr;
+    i64* entries = (i64*)(addr + CPU_DICT_ENTRIES_OFFSET);
+    for (size_t i = 0; i < *len; i++) {
+        if (cpu_string_equals(search_key_addr, cpu_dict_entry_key(entries[i])))
+            return entries[i];
+    }
 
     return 0;
 }
@@ -921,7 +1568,20 @@ i64 cpu_dict_key_search(i64 addr, i64 search_key_addr)
 void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
+    i64* element_type = (i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    if (*element_type == r0) {
+        if (r0 == V_FLOAT)
+            memcpy(&r1, &fr1, sizeof(f64));
+        if (i < 0)
+            i = *len + i;
+        cpu_list_elements(addr)[i] = r1;
+        return;
+    }
+    // An element of another type turns the list into a list of refs
+    if (*element_type != V_ANY)
+        cpu_list_box(addr);
+
+    addr = (i64)cpu_list_elements(addr);
     if (i < 0)
         i = *len + i;
 
@@ -937,42 +1597,25 @@ void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1)
 
 void cpu_dict_key_update(i64 addr, i64 search_key_addr, i64 r0, i64 r1, f64 fr1)
 {
-    size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
-
-    for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
-
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
-        i64 value_ref = *(i64*)key_value_pair;
-
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
-
-        if (strcmp(search_key, key) == 0) {
-            *(i64*)value_ref = r0;
-            value_ref += sizeof(i64);
-            if (r0 == V_FLOAT)
-                *(f64*)value_ref = fr1;
-            else
-                *(i64*)value_ref = r1;
-            return;
-        }
-    }
+    i64 key_value_pair = cpu_dict_find_entry(addr, search_key_addr);
 
     // TODO: throw error
+    if (key_value_pair == 0)
+        return;
+
+    key_value_pair += sizeof(i64);
+    i64 value_ref = *(i64*)key_value_pair;
+    *(i64*)value_ref = r0;
+    value_ref += sizeof(i64);
+    if (r0 == V_FLOAT)
+        *(f64*)value_ref = fr1;
+    else
+        *(i64*)value_ref = r1;
 }
 
 i64 cpu_new_common(i64 type, i64 val)
 {
-    i64 p = (i64)malloc(2 * sizeof(i64));
+    i64 p = (i64)gc_alloc(2 * sizeof(i64));
     i64 orig_p = p;
     i64* p1 = (i64*)p;
     *p1 = type;
@@ -983,54 +1626,81 @@ i64 cpu_new_common(i64 type, i64 val)
 }
 
 i64 cpu_new_string(i64 addr)
+{
+    return cpu_new_common(V_STRING, cpu_string_copy(addr));
+}
+
+i64 cpu_string_copy(i64 addr)
 {
     size_t* len = (size_t*)addr;
     addr += sizeof(size_t);
     char* s = (char*)addr;
-    i64 new_str = (i64)malloc((*len + 1) * sizeof(char) + sizeof(size_t));
+    i64 new_str = cpu_string_alloc(*len);
     i64 orig_new_str = new_str;
-    size_t* new_len = (size_t*)new_str;
-    *new_len = *len;
     new_str += sizeof(size_t);
     char* new_s = (char*)new_str;
     memcpy(new_s, s, (*len + 1) * sizeof(char));
-    return cpu_new_common(V_STRING, orig_new_str);
+    return orig_new_str;
+}
+
+i64 cpu_new_unboxed_element(i64 type, i64 val)
+{
+    if (type == V_STRING)
+        return cpu_string_copy(val);
+    return val;
+}
+
+i64 cpu_new_element(i64 type, i64 val)
+{
+    i64 p = 0;
+    switch (type) {
+    case V_BOOL:
+    case V_INT:
+    case V_FLOAT:
+        p = cpu_new_common(type, val);
+        break;
+    case V_STRING:
+        p = cpu_new_string(val);
+        break;
+    case V_LIST:
+        p = (i64)gc_alloc(2 * sizeof(i64));
+        cpu_new_list(val, p);
+        break;
+    case V_DICT:
+        p = (i64)gc_alloc(2 * sizeof(i64));
+        cpu_new_dict(val, p);
+        break;
+    default:
+        break;
+    }
+    return p;
 }
 
 void cpu_new_list(i64 addr, i64 new_addr)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64 ref_addr = (i64)malloc(sizeof(i64) * *len + sizeof(size_t));
+    i64 element_type = *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    addr = (i64)cpu_list_elements(addr);
+    // The copy fits exactly into its inline storage until it grows
+    i64 ref_addr = (i64)gc_alloc(sizeof(i64) * *len + CPU_LIST_HEADER_SIZE);
     i64 orig_ref_addr = ref_addr;
     size_t* new_len = (size_t*)ref_addr;
     *new_len = *len;
-    ref_addr += sizeof(size_t);
+    *(size_t*)(orig_ref_addr + CPU_LIST_CAPACITY_OFFSET) = *len;
+    *(i64*)(orig_ref_addr + CPU_LIST_ELEMENT_TYPE_OFFSET) = element_type;
+    *(i64*)(orig_ref_addr + CPU_LIST_FLAGS_OFFSET) = CPU_COMPOSITE_HEAP;
+    ref_addr += CPU_LIST_HEADER_SIZE;
+    *(i64*)(orig_ref_addr + CPU_LIST_ELEMENTS_OFFSET) = ref_addr;
 
     for (size_t i = 0; i < *len; i++) {
-        i64 _addr = *(i64*)addr;
-        i64 type = *(i64*)_addr;
-        _addr += sizeof(i64);
         i64* p = (i64*)ref_addr;
-        switch (type) {
-        case V_BOOL:
-        case V_INT:
-        case V_FLOAT:
-            *p = cpu_new_common(type, *(i64*)_addr);
-            break;
-        case V_STRING:
-            *p = cpu_new_string(*(i64*)_addr);
-            break;
-        case V_LIST:
-            *p = (i64)malloc(2 * sizeof(i64));
-            cpu_new_list(*(i64*)_addr, *p);
-            break;
-        case V_DICT:
-            *p = (i64)malloc(2 * sizeof(i64));
-            cpu_new_dict(*(i64*)_addr, *p);
-            break;
-        default:
-            break;
+        if (element_type == V_ANY) {
+            i64 _addr = *(i64*)addr;
+            i64 type = *(i64*)_addr;
+            _addr += sizeof(i64);
+            *p = cpu_share_element(type, *(i64*)_addr);
+        } else {
+            *p = cpu_new_unboxed_element(element_type, *(i64*)addr);
         }
 
         addr += sizeof(i64);
@@ -1044,15 +1714,30 @@ void cpu_new_list(i64 addr, i64 new_addr)
     *p2 = orig_ref_addr;
 }
 
+i64 cpu_new_unboxed_list(i64 element_type, size_t len)
+{
+    // The elements are left for the caller to fill
+    i64 addr = (i64)gc_alloc(sizeof(i64) * len + CPU_LIST_HEADER_SIZE);
+    *(size_t*)addr = len;
+    *(size_t*)(addr + CPU_LIST_CAPACITY_OFFSET) = len;
+    *(i64*)(addr + CPU_LIST_ELEMENTS_OFFSET) = addr + CPU_LIST_HEADER_SIZE;
+    *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET) = element_type;
+    *(i64*)(addr + CPU_LIST_FLAGS_OFFSET) = CPU_COMPOSITE_HEAP;
+    return addr;
+}
+
 void cpu_new_dict(i64 addr, i64 new_addr)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64 ref_addr = (i64)malloc(sizeof(i64) * *len + sizeof(size_t));
+    addr += CPU_DICT_ENTRIES_OFFSET;
+    i64 ref_addr = (i64)gc_alloc(sizeof(i64) * *len + CPU_DICT_ENTRIES_OFFSET);
     i64 orig_ref_addr = ref_addr;
     size_t* new_len = (size_t*)ref_addr;
     *new_len = *len;
-    ref_addr += sizeof(size_t);
+    // The copy builds its own hash index on the first key lookup
+    *(cpu_dict_index**)(ref_addr + CPU_DICT_INDEX_OFFSET) = NULL;
+    *(i64*)(ref_addr + CPU_DICT_FLAGS_OFFSET) = CPU_COMPOSITE_HEAP;
+    ref_addr += CPU_DICT_ENTRIES_OFFSET;
 
     for (size_t i = 0; i < *len; i++) {
         i64 key_value_pair = *(i64*)addr;
@@ -1062,38 +1747,19 @@ void cpu_new_dict(i64 addr, i64 new_addr)
         i64 value_ref = *(i64*)key_value_pair;
         key_ref += sizeof(i64);
 
-        i64 new_key_value_pair = (i64)malloc(2 * sizeof(i64));
+        i64 new_key_value_pair = (i64)gc_alloc(2 * sizeof(i64));
         i64* p = (i64*)ref_addr;
         *p = new_key_value_pair;
 
+        // The copies share the interned keys instead of copying them
         i64* new_key = (i64*)new_key_value_pair;
-        *new_key = cpu_new_string(*(i64*)key_ref);
+        *new_key = cpu_new_common(V_STRING, cpu_string_intern(*(i64*)key_ref));
         new_key_value_pair += sizeof(i64);
         i64* new_value = (i64*)new_key_value_pair;
 
         i64 type = *(i64*)value_ref;
         value_ref += sizeof(i64);
-
-        switch (type) {
-        case V_BOOL:
-        case V_INT:
-        case V_FLOAT:
-            *new_value = cpu_new_common(type, *(i64*)value_ref);
-            break;
-        case V_STRING:
-            *new_value = cpu_new_string(*(i64*)value_ref);
-            break;
-        case V_LIST:
-            *new_value = (i64)malloc(2 * sizeof(i64));
-            cpu_new_list(*(i64*)value_ref, *new_value);
-            break;
-        case V_DICT:
-            *new_value = (i64)malloc(2 * sizeof(i64));
-            cpu_new_dict(*(i64*)value_ref, *new_value);
-            break;
-        default:
-            break;
-        }
+        *new_value = cpu_share_element(type, *(i64*)value_ref);
 
         addr += sizeof(i64);
         ref_addr += sizeof(i64);
@@ -1106,12 +1772,82 @@ void cpu_new_dict(i64 addr, i64 new_addr)
     *p2 = orig_ref_addr;
 }
 
+i64* cpu_composite_flags(i64 type, i64 addr)
+{
+    if (type == V_LIST)
+        return (i64*)(addr + CPU_LIST_FLAGS_OFFSET);
+    return (i64*)(addr + CPU_DICT_FLAGS_OFFSET);
+}
+
+i64 cpu_composite_share(i64 type, i64 addr)
+{
+    if (type != V_LIST && type != V_DICT)
+        return addr;
+
+    i64* flags = cpu_composite_flags(type, addr);
+    if (*flags & CPU_COMPOSITE_HEAP) {
+        *flags |= CPU_COMPOSITE_SHARED;
+        return addr;
+    }
+
+    // A literal is copied once, the copy can be shared from then on
+    i64 cell[2];
+    if (type == V_LIST)
+        cpu_new_list(addr, (i64)cell);
+    else
+        cpu_new_dict(addr, (i64)cell);
+    return cell[1];
+}
+
+i64 cpu_composite_unshare(i64 type, i64 addr)
+{
+    if (type != V_LIST && type != V_DICT)
+        return addr;
+
+    // The flag is never cleared since no owner lets go of it explicitly,
+    // so the last owner that modifies it makes one more copy
+    if (!(*cpu_composite_flags(type, addr) & CPU_COMPOSITE_SHARED))
+        return addr;
+
+    // Only this level is copied, the containers in it become shared between the two copies
+    i64 cell[2];
+    if (type == V_LIST)
+        cpu_new_list(addr, (i64)cell);
+    else
+        cpu_new_dict(addr, (i64)cell);
+    return cell[1];
+}
+
+void cpu_composite_unshare_element(i64 addr, i64 type, i64 val)
+{
+    // The unboxed lists hold no containers
+    if (type == V_LIST && *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET) != V_ANY)
+        return;
+
+    i64 element = cpu_composite_access(addr, type, val);
+    if (element == 0)
+        return;
+
+    i64* value = (i64*)(element + sizeof(i64));
+    *value = cpu_composite_unshare(*(i64*)element, *value);
+}
+
+i64 cpu_share_element(i64 type, i64 val)
+{
+    if (type == V_LIST || type == V_DICT)
+        return cpu_new_common(type, cpu_composite_share(type, val));
+    return cpu_new_element(type, val);
+}
+
 void cpu_delete_string_index(i64 i, i64 addr)
 {
     size_t* len = (size_t*)addr;
     if (i < 0)
         i = *len + i;
 
+    // The content changes, so does its hash
+    CPU_STRING_HEADER(addr)->flags &= ~CPU_STRING_HASHED;
+
     addr += sizeof(size_t);
     char *s = (char*)addr;
     memmove(&s[i], &s[i + 1], (*len - i) * sizeof(char));
@@ -1124,88 +1860,144 @@ void cpu_delete_list_index(i64 i, i64 addr)
     if (i < 0)
         i = *len + i;
 
-    addr += sizeof(size_t);
-    i64* arr = (i64*)addr;
-    memmove(&arr[i], &arr[i + 1], (*len - (size_t)i) * sizeof(i64));
+    i64* arr = cpu_list_elements(addr);
+    memmove(&arr[i], &arr[i + 1], (*len - (size_t)i - 1) * sizeof(i64));
     *len -= 1;
 }
 
 void cpu_delete_dict_key(i64 search_key_addr, i64 addr)
 {
     size_t* len = (size_t*)addr;
-    addr += sizeof(size_t);
-    i64* arr = (i64*)addr;
+    i64* arr = (i64*)(addr + CPU_DICT_ENTRIES_OFFSET);
+
+    i64 key_value_pair = 0;
+    cpu_dict_index* index = cpu_dict_get_index(addr);
+    if (index != NULL) {
+        cpu_dict_slot* slot = cpu_dict_find_slot(index, cpu_string_get_hash(search_key_addr), search_key_addr);
+        key_value_pair = slot->key_value_pair;
+        if (key_value_pair != 0)
+            slot->key_value_pair = CPU_DICT_TOMBSTONE;
+    } else {
+        key_value_pair = cpu_dict_find_entry(addr, search_key_addr);
+    }
 
-    search_key_addr += sizeof(size_t);
-    char* search_key = (char*)search_key_addr;
+    if (key_value_pair == 0)
+        return;
 
+    // Keep the insertion order of the remaining entries
     for (size_t i = 0; i < *len; i++) {
-        i64 key_value_pair = *(i64*)addr;
-        addr += sizeof(i64);
+        if (arr[i] != key_value_pair)
+            continue;
+        memmove(&arr[i], &arr[i + 1], (*len - i - 1) * sizeof(i64));
+        *len -= 1;
+        return;
+    }
+}
 
-        i64 key_ref = *(i64*)key_value_pair;
-        key_value_pair += sizeof(i64);
+i64 cpu_string_concat(i64 addr1, i64 addr2)
+{
+    size_t len1 = *(size_t*)addr1;
+    size_t len2 = *(size_t*)addr2;
+    char *s1 = (char*)(addr1 + sizeof(size_t));
+    char *s2 = (char*)(addr2 + sizeof(size_t));
 
-        key_ref += sizeof(i64);
-        i64 key_addr = *(i64*)key_ref;
-        key_addr += sizeof(size_t);
-        char* key = (char*)key_addr;
+    if (len1 + len2 == 1)
+        return cpu_char_string_get(len1 == 1 ? *s1 : *s2);
 
-        if (strcmp(search_key, key) == 0) {
-            memmove(&arr[i], &arr[i + 1], (*len - (size_t)i) * sizeof(i64));
-            *len -= 1;
-            return;
-        }
-    }
+    // Allocate a new space to store the concatenated string, with its size set
+    i64 p = cpu_string_alloc(len1 + len2);
+
+    // Copy the both strings, the lengths are known so there is no need to scan them
+    char *p_s = (char*)(p + sizeof(size_t));
+    memcpy(p_s, s1, len1 * sizeof(char));
+    memcpy(p_s + len1, s2, (len2 + 1) * sizeof(char));
+    return p;
 }
 
-i64 cpu_string_concat(i64 addr1, i64 addr2)
+i64 cpu_string_append(i64 addr1, i64 addr2)
 {
-    size_t* t1 = (size_t*)addr1;
-    size_t* t2 = (size_t*)addr2;
-    size_t t3 = *t1 + *t2;
-    addr1 += sizeof(size_t);
-    addr2 += sizeof(size_t);
-    char *s1 = (char*)addr1;
-    char *s2 = (char*)addr2;
-
-    // Allocate a new space to store the concatenated string
-    i64 p = (i64)malloc((t3 + 1) * sizeof(char) + sizeof(size_t));
-
-    // Set the new string size
-    size_t* p_t = (size_t*)p;
-    *p_t = t3;
-
-    // Copy the first string
-    p += sizeof(size_t);
-    char *p_s = (char*)p;
-    strcpy(p_s, s1);
-
-    // Copy the second string
-    p += *t1 * sizeof(char);
-    char *p_s2 = (char*)p;
-    strcpy(p_s2, s2);
-
-    // Reset the pointer and return
-    p -= sizeof(size_t) + *t1 * sizeof(char);
+    size_t len1 = *(size_t*)addr1;
+    size_t len2 = *(size_t*)addr2;
+    size_t len = len1 + len2;
+    char *s2 = (char*)(addr2 + sizeof(size_t));
+
+    // The builder is only referenced by the variable that is appended to, so it's grown in-place
+    cpu_string_header* header = CPU_STRING_HEADER(addr1);
+    if ((header->flags & CPU_STRING_BUILDER) && len <= cpu_string_capacity(addr1)) {
+        char *p_s = (char*)(addr1 + sizeof(size_t));
+        memcpy(p_s + len1, s2, (len2 + 1) * sizeof(char));
+        *(size_t*)addr1 = len;
+        header->flags &= ~CPU_STRING_HASHED;
+        return addr1;
+    }
+
+    // Otherwise start a new builder with the room for as much again
+    size_t capacity = len * 2;
+    if (capacity < CPU_STRING_BUILDER_MIN_CAPACITY)
+        capacity = CPU_STRING_BUILDER_MIN_CAPACITY;
+
+    i64 p = cpu_string_alloc(capacity);
+    *(size_t*)p = len;
+    CPU_STRING_HEADER(p)->flags = CPU_STRING_BUILDER;
+
+    char *p_s = (char*)(p + sizeof(size_t));
+    memcpy(p_s, (char*)(addr1 + sizeof(size_t)), len1 * sizeof(char));
+    memcpy(p_s + len1, s2, (len2 + 1) * sizeof(char));
     return p;
 }
 
+size_t cpu_string_capacity(i64 addr)
+{
+    return gc_size(CPU_STRING_HEADER(addr)) - sizeof(cpu_string_header) - sizeof(size_t) - sizeof(char);
+}
+
+i64 cpu_char_string_get(char c)
+{
+    return (i64)&cpu_char_strings[(unsigned char)c].size;
+}
+
+void cpu_init_char_strings()
+{
+    // Another CPU might be created for the same process, the strings might be interned already
+    if (cpu_char_strings[0].header.flags & CPU_STRING_CONSTANT)
+        return;
+
+    for (size_t i = 0; i < CPU_CHAR_STRING_COUNT; i++) {
+        cpu_char_string* char_string = &cpu_char_strings[i];
+        char_string->header.hash = 0;
+        char_string->header.flags = CPU_STRING_CONSTANT;
+        char_string->size = 1;
+        char_string->s[0] = (char)i;
+        char_string->s[1] = '\0';
+    }
+}
+
+i64 cpu_string_unshare(i64 addr)
+{
+    // The constant and the interned strings are shared, the others are modified in-place
+    cpu_string_header* header = CPU_STRING_HEADER(addr);
+    if (!(header->flags & (CPU_STRING_CONSTANT | CPU_STRING_INTERNED))) {
+        header->flags &= ~CPU_STRING_HASHED;
+        return addr;
+    }
+
+    size_t* len = (size_t*)addr;
+    size_t size = (*len + 1) * sizeof(char) + sizeof(size_t);
+    i64 new_str = cpu_string_alloc(*len);
+    memcpy((void*)new_str, (void*)addr, size);
+    return new_str;
+}
+
 i64 cpu_boolean_to_string(i64 val)
 {
     i64 p = 0;
-    size_t* p_t = 0;
     if (val == 0) {
-        p = (i64)malloc((strlen("false") + 1) * sizeof(size_t));
-        p_t = (size_t*)p;
-        *p_t = 5;
+        p = cpu_string_alloc(5);
         p += sizeof(size_t);
         char *p_s = (char*)p;
         strcpy(p_s, "false");
     } else {
-        p = (i64)malloc((strlen("true") + 1) * sizeof(size_t));
-        p_t = (size_t*)p;
-        *p_t = 4;
+        p = cpu_string_alloc(4);
         p += sizeof(size_t);
         char *p_s = (char*)p;
         strcpy(p_s, "true");
@@ -1231,21 +2023,6 @@ i64 cpu_get_composite_len(i64 addr)
     return (i64)*len;
 }
 
-void cpu_set_break_current_loop()
-{
-    break_current_loop = true;
-}
-
-i64 cpu_get_break_current_loop()
-{
-    i64 val = 0;
-    if (break_current_loop) {
-        val = 1;
-        break_current_loop = false;
-    }
-    return val;
-}
-
 void debug(struct jit *jit)
 {
     jit_msg(jit, " ----------------------------------------------------------\n");
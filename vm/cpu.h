@@ -29,6 +29,7 @@
 #include <math.h>
 
 #include "ir.h"
+#include "gc.h"
 
 #include "../enums.h"
 #include "../utilities/helpers.h"
@@ -53,21 +54,138 @@ typedef struct jit_op_array {
     i64 hlt_count;
 } jit_op_array;
 
+typedef struct jit_function {
+    i64 start;
+    i64 end;
+    struct jit* jit;
+    void* code;
+    // The interpreter tier and its counters that decide when the function is hot
+    struct tier0_function* tier0;
+    i64 call_count;
+    i64 back_edge_count;
+} jit_function;
+
+typedef struct jit_function_table {
+    jit_function* arr;
+    i64 size;
+    i64 main_start;
+} jit_function_table;
+
+/*
+  -16    -8      0      8                     size+8       size+9
+  +------+-------+------+ +-----------------+ +-----------------+
+  | hash | flags | size | |     string      | | null-terminator |
+  +------+-------+------+ +-----------------+ +-----------------+
+    u64     u64   size_t     size * char             char
+
+  The strings are referenced by the address of their size field,
+  the header that precedes it is only read by the runtime.
+*/
+typedef struct cpu_string_header {
+    u64 hash;
+    u64 flags;
+} cpu_string_header;
+
+#define CPU_STRING_HEADER(addr) ((cpu_string_header*)((addr) - sizeof(cpu_string_header)))
+// The hash field holds the hash of the current content
+#define CPU_STRING_HASHED (1 << 0)
+// Lives in the constant data, must be copied before it's modified
+#define CPU_STRING_CONSTANT (1 << 1)
+// Owned by the intern table, equal interned strings are the same string
+#define CPU_STRING_INTERNED (1 << 2)
+// Owned by a single variable that appends to it, has spare capacity after its content
+#define CPU_STRING_BUILDER (1 << 3)
+// The smallest capacity of a string that is grown by appending
+#define CPU_STRING_BUILDER_MIN_CAPACITY 32
+
+// The single character strings are preallocated, one for each byte value
+#define CPU_CHAR_STRING_COUNT 256
+
+typedef struct cpu_char_string {
+    cpu_string_header header;
+    size_t size;
+    char s[8];
+} cpu_char_string;
+
+#define CPU_INTERN_TABLE_INITIAL_CAPACITY 64
+
+/*
+  0      8          16         24             32      40                capacity*8+40
+  +------+----------+----------+--------------+-------+ +-----------------+
+  | size | capacity | elements | element type | flags | |     inline      |
+  +------+----------+----------+--------------+-------+ +-----------------+
+   size_t   size_t      i64*         i64         i64       capacity * i64
+                                                         ref or value (list)
+*/
+#define CPU_LIST_CAPACITY_OFFSET sizeof(size_t)
+#define CPU_LIST_ELEMENTS_OFFSET (2 * sizeof(size_t))
+#define CPU_LIST_ELEMENT_TYPE_OFFSET (2 * sizeof(size_t) + sizeof(i64))
+#define CPU_LIST_FLAGS_OFFSET (2 * sizeof(size_t) + 2 * sizeof(i64))
+#define CPU_LIST_HEADER_SIZE (2 * sizeof(size_t) + 3 * sizeof(i64))
+// The elements of a list move out of its inline storage on the first growth
+#define CPU_LIST_MIN_CAPACITY 4
+// The lists of a single scalar type hold the raw values instead of the refs,
+// the element type of a list of refs is `V_ANY`
+#define CPU_LIST_IS_UNBOXED_TYPE(type) ((type) == V_BOOL || (type) == V_INT || (type) == V_FLOAT || (type) == V_STRING)
+
+/*
+  0      8       16      24             size+24
+  +------+-------+-------+ +-----------------+
+  | size | index | flags | |     entries     |
+  +------+-------+-------+ +-----------------+
+   size_t   i64     i64        size * i64
+                           key-value (insertion order)
+*/
+#define CPU_DICT_INDEX_OFFSET sizeof(size_t)
+#define CPU_DICT_FLAGS_OFFSET (sizeof(size_t) + sizeof(i64))
+#define CPU_DICT_ENTRIES_OFFSET (sizeof(size_t) + 2 * sizeof(i64))
+// The small dictionaries are scanned instead of being indexed
+#define CPU_DICT_LINEAR_SCAN_LIMIT 8
+#define CPU_DICT_TOMBSTONE -1
+
+// Allocated by the runtime, the literals live in the frame that built them so they are never shared
+#define CPU_COMPOSITE_HEAP (1 << 0)
+// Referenced by more than one owner, copied before it's modified
+#define CPU_COMPOSITE_SHARED (1 << 1)
+
+typedef struct cpu_dict_slot {
+    u64 hash;
+    i64 key_value_pair;
+} cpu_dict_slot;
+
+// Open addressing hash index over the entries of a dictionary
+typedef struct cpu_dict_index {
+    size_t capacity;
+    cpu_dict_slot slots[];
+} cpu_dict_index;
+
+// Holds the address of the function being called in between the `PREPARE` and `CALL` instructions
+#define CPU_CALL_TARGET_REGISTER (IR_PROMOTED_REGISTERS_START - 1)
+
+// The stack offsets of the ALLOCAI slots are recorded in an array that doubles its size when it's full
+#define CPU_STACK_INITIAL_CAPACITY 256
+
 cpu *new_cpu(KaosIR* program, unsigned short debug_level);
 void free_cpu(cpu *c);
+void grow_cpu_stack(cpu *c, i64 i);
 void run_cpu(cpu *c);
 void eat_until_hlt(cpu *c);
 void fetch(cpu *c);
 void execute(cpu *c);
 
 jit_label_array* init_label_array();
-void push_label(jit_label_array* label_array, jit_label* label);
+void set_label(jit_label_array* label_array, i64 i, jit_label* label);
 jit_label* get_label(jit_label_array* label_array, i64 i);
 
 jit_op_array* init_op_array();
-void push_op(jit_op_array* op_array, jit_op* op);
+void set_op(jit_op_array* op_array, i64 i, jit_op* op);
 jit_op* get_op(jit_op_array* op_array, i64 i);
 
+jit_function_table* init_function_table(KaosIR* program);
+void load_call_target(cpu *c);
+i64 cpu_compile_function(i64 label);
+void cpu_exit(i64 status);
+
 void cpu_dyn_print(i64 newline, i64 pretty);
 void cpu_print(i64 r0, i64 r1, f64 fr1, i64 nl, i64 pretty);
 void cpu_print_bool(i64 i);
@@ -82,23 +200,54 @@ void cpu_delete_string_index(i64 index, i64 addr);
 void cpu_delete_list_index(i64 index, i64 addr);
 void cpu_delete_dict_key(i64 search_key_addr, i64 addr);
 i64 cpu_string_concat(i64 addr1, i64 addr2);
+i64 cpu_string_append(i64 addr1, i64 addr2);
+i64 cpu_char_string_get(char c);
+void cpu_init_char_strings();
+size_t cpu_string_capacity(i64 addr);
+i64 cpu_string_unshare(i64 addr);
 i64 cpu_boolean_to_string(i64 val);
 i64 cpu_string_to_boolean(i64 addr);
 i64 cpu_composite_access(i64 addr, i64 type, i64 val);
+i64 cpu_composite_element(i64 ast, i64 addr, i64 type, i64 val);
 i64 cpu_list_index_access(i64 addr, i64 i);
+i64* cpu_list_elements(i64 addr);
+void cpu_list_reserve(i64 addr, size_t capacity);
+void cpu_list_box(i64 addr);
+i64 cpu_list_prepare_element(i64 addr, i64 type, i64 val);
+void cpu_list_append(i64 addr, i64 r0, i64 r1, f64 fr1);
+void cpu_list_extend(i64 addr, i64 other_addr);
+void cpu_list_insert(i64 ast, i64 addr, i64 i, i64 r0, i64 r1, f64 fr1);
 i64 cpu_dict_key_search(i64 addr, i64 search_key_addr);
+u64 cpu_string_hash(char* s);
+u64 cpu_string_get_hash(i64 addr);
+bool cpu_string_equals(i64 addr1, i64 addr2);
+i64 cpu_string_alloc(size_t len);
+i64 cpu_string_intern(i64 addr);
+void cpu_intern_table_insert(i64 addr);
+void cpu_intern_table_prune();
+i64 cpu_dict_entry_key(i64 key_value_pair);
+cpu_dict_index* cpu_dict_get_index(i64 addr);
+cpu_dict_slot* cpu_dict_find_slot(cpu_dict_index* index, u64 hash, i64 search_key_addr);
+i64 cpu_dict_find_entry(i64 addr, i64 search_key_addr);
 void cpu_list_index_update(i64 addr, i64 i, i64 r0, i64 r1, f64 fr1);
 void cpu_dict_key_update(i64 addr, i64 search_key_addr, i64 r0, i64 r1, f64 fr1);
 
 i64 cpu_new_common(i64 type, i64 val);
+i64 cpu_new_element(i64 type, i64 val);
 i64 cpu_new_string(i64 addr);
+i64 cpu_string_copy(i64 addr);
+i64 cpu_new_unboxed_element(i64 type, i64 val);
 void cpu_new_list(i64 addr, i64 new_addr);
+i64 cpu_new_unboxed_list(i64 element_type, size_t len);
 void cpu_new_dict(i64 addr, i64 new_addr);
+i64* cpu_composite_flags(i64 type, i64 addr);
+i64 cpu_composite_share(i64 type, i64 addr);
+i64 cpu_composite_unshare(i64 type, i64 addr);
+void cpu_composite_unshare_element(i64 addr, i64 type, i64 val);
+i64 cpu_share_element(i64 type, i64 val);
 
 i64 cpu_get_composite_len(i64 addr);
 
-void cpu_set_break_current_loop();
-i64 cpu_get_break_current_loop();
 
 void debug(struct jit *jit);
 
@@ -128,7 +277,7 @@ void debug(struct jit *jit);
     jit_patch(_jit, float_op_label_4); \
 \
     /* Do the float operation */ \
-    _ffn(_jit, FR(1), FR(2), FR(1)); \
+    _ffn(_jit, FR(1), FR(1), FR(2)); \
 \
     /* Set the jump point to dodge the float operation */ \
     jit_patch(_jit, float_op_label_5); \
@@ -188,4 +337,11 @@ void debug(struct jit *jit);
     jit_patch(_jit, float_op_label_5); \
     jit_movr(_jit, R(1), R(3)); \
 
+#define FLOAT_COMPARISON(_ffn) \
+    /* Assume the comparison holds and reset the result if the branch is not taken */ \
+    jit_movi(_jit, R(c->inst->op1.reg), 1); \
+    jit_op* float_comp_label_true = _ffn(_jit, JIT_FORWARD, FR(c->inst->op2.reg), FR(c->inst->op3.reg)); \
+    jit_movi(_jit, R(c->inst->op1.reg), 0); \
+    jit_patch(_jit, float_comp_label_true); \
+
 #endif
@@ -0,0 +1,422 @@
+/*
+ * Description: Garbage collector of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "gc.h"
+#include "cpu.h"
+
+gc_object* gc_heap = NULL;
+size_t gc_heap_count = 0;
+gc_statistics gc_stats;
+
+// The collections only run while there is a stack to take the roots from
+void* gc_stack_base = NULL;
+size_t gc_threshold = GC_INITIAL_THRESHOLD;
+size_t gc_allocated_since_collection = 0;
+
+gc_root* gc_roots = NULL;
+size_t gc_root_count = 0;
+size_t gc_root_capacity = 0;
+
+// The objects sorted by their addresses, so the interior pointers can be resolved
+gc_object** gc_sorted_objects = NULL;
+size_t gc_sorted_count = 0;
+size_t gc_sorted_capacity = 0;
+i64 gc_heap_low = 0;
+i64 gc_heap_high = 0;
+
+// The marked objects whose payloads are not scanned yet
+gc_range* gc_pending = NULL;
+size_t gc_pending_count = 0;
+size_t gc_pending_capacity = 0;
+
+void gc_set_stack_base(void* stack_base)
+{
+    gc_stack_base = stack_base;
+}
+
+void* gc_alloc(size_t size)
+{
+    return gc_alloc_object(size, 0);
+}
+
+void* gc_alloc_atomic(size_t size)
+{
+    return gc_alloc_object(size, GC_ATOMIC);
+}
+
+void* gc_alloc_object(size_t size, u64 flags)
+{
+    // The small objects are packed into the slabs of their size class
+    if (size <= POOL_MAX_OBJECT_SIZE) {
+        i64 size_class = pool_size_class(size);
+        size_t class_size = pool_class_size(size_class);
+        gc_maybe_collect(class_size);
+
+        void* ptr = pool_alloc(size_class, flags & GC_ATOMIC);
+        gc_stats.allocated_bytes += class_size;
+        gc_stats.allocated_objects++;
+        gc_stats.live_bytes += class_size;
+        gc_stats.live_objects++;
+        return ptr;
+    }
+
+    // Every allocation is a safepoint
+    gc_maybe_collect(size);
+
+    // The garbage left in a fresh payload would be scanned as if it were pointers
+    gc_object* object = flags & GC_ATOMIC ? malloc(sizeof(gc_object) + size) : calloc(1, sizeof(gc_object) + size);
+    object->size = size;
+    object->flags = flags;
+    gc_link(object);
+
+    gc_stats.allocated_bytes += size;
+    gc_stats.allocated_objects++;
+    return GC_PAYLOAD(object);
+}
+
+void* gc_realloc(void* ptr, size_t size)
+{
+    if (ptr == NULL)
+        return gc_alloc(size);
+
+    // An object moves out of the pool, or into a larger class of it, by copying
+    pool_slab* slab = pool_find_slab((i64)ptr);
+    if (slab != NULL) {
+        i64 i = ((byte*)ptr - slab->start) / slab->object_size;
+        if (size <= slab->object_size)
+            return ptr;
+
+        void* new_ptr = gc_alloc_object(size, POOL_BIT_TEST(slab->atomic, i) ? GC_ATOMIC : 0);
+        memcpy(new_ptr, ptr, slab->object_size);
+        gc_free(ptr);
+        return new_ptr;
+    }
+
+    gc_object* object = GC_OBJECT(ptr);
+    size_t old_size = object->size;
+    if (size > old_size)
+        gc_maybe_collect(size - old_size);
+
+    gc_unlink(object);
+    object = realloc(object, sizeof(gc_object) + size);
+    if (size > old_size && !(object->flags & GC_ATOMIC))
+        memset((byte*)GC_PAYLOAD(object) + old_size, 0, size - old_size);
+    object->size = size;
+    gc_link(object);
+
+    if (size > old_size)
+        gc_stats.allocated_bytes += size - old_size;
+    return GC_PAYLOAD(object);
+}
+
+void gc_free(void* ptr)
+{
+    if (ptr == NULL)
+        return;
+
+    pool_slab* slab = pool_find_slab((i64)ptr);
+    if (slab != NULL) {
+        gc_stats.live_bytes -= slab->object_size;
+        gc_stats.live_objects--;
+        pool_free(slab, ptr);
+        return;
+    }
+
+    gc_object* object = GC_OBJECT(ptr);
+    gc_unlink(object);
+    free(object);
+}
+
+size_t gc_size(void* ptr)
+{
+    // The objects in the pool can use the whole of their size class
+    pool_slab* slab = pool_find_slab((i64)ptr);
+    if (slab != NULL)
+        return slab->object_size;
+
+    return GC_OBJECT(ptr)->size;
+}
+
+void gc_add_root(void* start, size_t size)
+{
+    for (size_t i = 0; i < gc_root_count; i++) {
+        if (gc_roots[i].start == start) {
+            gc_roots[i].size = size;
+            return;
+        }
+    }
+
+    if (gc_root_count == gc_root_capacity) {
+        gc_root_capacity = gc_root_capacity == 0 ? GC_ROOTS_INITIAL_CAPACITY : gc_root_capacity * 2;
+        gc_roots = realloc(gc_roots, gc_root_capacity * sizeof(gc_root));
+    }
+    gc_roots[gc_root_count].start = start;
+    gc_roots[gc_root_count].size = size;
+    gc_root_count++;
+}
+
+void gc_maybe_collect(size_t size)
+{
+    gc_allocated_since_collection += size;
+    if (gc_stack_base == NULL || gc_allocated_since_collection < gc_threshold)
+        return;
+
+#ifdef GC_ADDRESS_SANITIZER
+    // The frames moved to the fake stacks of AddressSanitizer are not seen by the stack scan
+    return;
+#endif
+
+    gc_collect();
+}
+
+void gc_collect()
+{
+    clock_t start = clock();
+
+    gc_sort_objects();
+    for (size_t i = 0; i < gc_root_count; i++)
+        gc_mark_range(gc_roots[i].start, (byte*)gc_roots[i].start + gc_roots[i].size);
+    gc_mark_stack();
+    gc_drain_mark_stack();
+
+    // The intern table doesn't keep its strings alive
+    cpu_intern_table_prune();
+    gc_sweep();
+
+    // Let the heap grow in proportion to what survived, so the cost of a collection is amortized
+    gc_threshold = gc_stats.live_bytes * (GC_GROWTH_FACTOR - 1);
+    if (gc_threshold < GC_INITIAL_THRESHOLD)
+        gc_threshold = GC_INITIAL_THRESHOLD;
+    gc_allocated_since_collection = 0;
+
+    f64 pause = (f64)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+    gc_stats.collections++;
+    gc_stats.total_pause += pause;
+    if (pause > gc_stats.max_pause)
+        gc_stats.max_pause = pause;
+}
+
+void gc_link(gc_object* object)
+{
+    object->prev = NULL;
+    object->next = gc_heap;
+    if (gc_heap != NULL)
+        gc_heap->prev = object;
+    gc_heap = object;
+    gc_heap_count++;
+
+    gc_stats.live_bytes += object->size;
+    gc_stats.live_objects++;
+}
+
+void gc_unlink(gc_object* object)
+{
+    if (object->prev != NULL)
+        object->prev->next = object->next;
+    else
+        gc_heap = object->next;
+    if (object->next != NULL)
+        object->next->prev = object->prev;
+    gc_heap_count--;
+
+    gc_stats.live_bytes -= object->size;
+    gc_stats.live_objects--;
+}
+
+void gc_sort_objects()
+{
+    if (gc_heap_count > gc_sorted_capacity) {
+        gc_sorted_capacity = gc_heap_count * 2;
+        gc_sorted_objects = realloc(gc_sorted_objects, gc_sorted_capacity * sizeof(gc_object*));
+    }
+
+    gc_sorted_count = 0;
+    for (gc_object* object = gc_heap; object != NULL; object = object->next)
+        gc_sorted_objects[gc_sorted_count++] = object;
+    qsort(gc_sorted_objects, gc_sorted_count, sizeof(gc_object*), gc_compare_objects);
+
+    if (gc_sorted_count == 0) {
+        gc_heap_low = 0;
+        gc_heap_high = 0;
+        return;
+    }
+    gc_object* last = gc_sorted_objects[gc_sorted_count - 1];
+    gc_heap_low = (i64)GC_PAYLOAD(gc_sorted_objects[0]);
+    gc_heap_high = (i64)GC_PAYLOAD(last) + (i64)last->size;
+}
+
+int gc_compare_objects(const void* a, const void* b)
+{
+    uintptr_t x = (uintptr_t)*(gc_object**)a;
+    uintptr_t y = (uintptr_t)*(gc_object**)b;
+    return (x > y) - (x < y);
+}
+
+gc_object* gc_find_object(i64 addr)
+{
+    if (addr < gc_heap_low || addr >= gc_heap_high)
+        return NULL;
+
+    // Find the last object that starts at or before the address
+    size_t low = 0;
+    size_t high = gc_sorted_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((i64)gc_sorted_objects[mid] <= addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return NULL;
+
+    // The pointers into the payload keep the object alive, like the strings that are referenced by their size field
+    gc_object* object = gc_sorted_objects[low - 1];
+    i64 payload = (i64)GC_PAYLOAD(object);
+    if (addr < payload || addr >= payload + (i64)object->size)
+        return NULL;
+    return object;
+}
+
+bool gc_is_live(i64 addr)
+{
+    pool_slab* slab = pool_find_slab(addr);
+    if (slab != NULL) {
+        i64 i = pool_object_index(slab, addr);
+        return i == -1 || POOL_BIT_TEST(slab->marked, i);
+    }
+
+    // Anything that is not on the heap, like the constant strings, is never collected
+    gc_object* object = gc_find_object(addr);
+    return object == NULL || (object->flags & GC_MARKED);
+}
+
+void gc_mark_word(i64 addr)
+{
+    pool_slab* slab = pool_find_slab(addr);
+    if (slab != NULL) {
+        i64 i = pool_object_index(slab, addr);
+        if (i == -1 || POOL_BIT_TEST(slab->marked, i))
+            return;
+
+        POOL_BIT_SET(slab->marked, i);
+        if (!POOL_BIT_TEST(slab->atomic, i))
+            gc_push_pending(slab->start + i * slab->object_size, slab->object_size);
+        return;
+    }
+
+    gc_object* object = gc_find_object(addr);
+    if (object == NULL || (object->flags & GC_MARKED))
+        return;
+
+    object->flags |= GC_MARKED;
+    if (!(object->flags & GC_ATOMIC))
+        gc_push_pending(GC_PAYLOAD(object), object->size);
+}
+
+void gc_push_pending(void* start, size_t size)
+{
+    if (gc_pending_count == gc_pending_capacity) {
+        gc_pending_capacity = gc_pending_capacity == 0 ? GC_MARK_STACK_INITIAL_CAPACITY : gc_pending_capacity * 2;
+        gc_pending = realloc(gc_pending, gc_pending_capacity * sizeof(gc_range));
+    }
+    gc_pending[gc_pending_count].start = start;
+    gc_pending[gc_pending_count].size = size;
+    gc_pending_count++;
+}
+
+GC_NO_SANITIZE void gc_mark_range(void* start, void* end)
+{
+    // Every aligned word is taken as a possible pointer
+    uintptr_t aligned = ((uintptr_t)start + sizeof(i64) - 1) & ~(uintptr_t)(sizeof(i64) - 1);
+    for (i64* p = (i64*)aligned; (byte*)(p + 1) <= (byte*)end; p++) {
+        i64 word = *p;
+        GC_MAKE_MEM_DEFINED(&word, sizeof(word));
+        gc_mark_word(word);
+    }
+}
+
+GC_NO_SANITIZE GC_NOINLINE void gc_mark_stack()
+{
+    // Spill the callee-saved registers into this frame, the values that only live in
+    // the registers at the safepoint are scanned together with the JIT frames
+    jmp_buf registers;
+#if defined(__GNUC__)
+    __builtin_unwind_init();
+#endif
+    setjmp(registers);
+
+    gc_mark_range(&registers, gc_stack_base);
+}
+
+void gc_drain_mark_stack()
+{
+    while (gc_pending_count > 0) {
+        gc_range range = gc_pending[--gc_pending_count];
+        gc_mark_range(range.start, (byte*)range.start + range.size);
+    }
+}
+
+void gc_sweep()
+{
+    gc_object* object = gc_heap;
+    while (object != NULL) {
+        gc_object* next = object->next;
+        if (object->flags & GC_MARKED) {
+            object->flags &= ~GC_MARKED;
+        } else {
+            gc_stats.freed_bytes += object->size;
+            gc_stats.freed_objects++;
+            gc_unlink(object);
+            free(object);
+        }
+        object = next;
+    }
+
+    u64 freed_bytes = 0;
+    u64 freed_objects = 0;
+    pool_sweep(&freed_bytes, &freed_objects);
+    gc_stats.freed_bytes += freed_bytes;
+    gc_stats.freed_objects += freed_objects;
+    gc_stats.live_bytes -= freed_bytes;
+    gc_stats.live_objects -= freed_objects;
+
+    gc_sorted_count = 0;
+    gc_heap_low = 0;
+    gc_heap_high = 0;
+}
+
+void gc_print_stats()
+{
+    printf("\nGarbage Collector:\n");
+    printf("    collections: %llu\n", gc_stats.collections);
+    printf("    total pause: %.3f ms\n", gc_stats.total_pause);
+    printf("    max pause: %.3f ms\n", gc_stats.max_pause);
+    printf(
+        "    mean pause: %.3f ms\n",
+        gc_stats.collections == 0 ? 0.0 : gc_stats.total_pause / gc_stats.collections
+    );
+    printf("    allocated: %llu bytes in %llu objects\n", gc_stats.allocated_bytes, gc_stats.allocated_objects);
+    printf("    freed: %llu bytes in %llu objects\n", gc_stats.freed_bytes, gc_stats.freed_objects);
+    printf("    live: %llu bytes in %llu objects\n", gc_stats.live_bytes, gc_stats.live_objects);
+    pool_print_stats();
+}
@@ -0,0 +1,150 @@
+/*
+ * Description: Garbage collector of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef GC_H
+#define GC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "types.h"
+#include "pool.h"
+
+/*
+  -32    -24    -16     -8      0                   size
+  +------+------+------+-------+ +-----------------+
+  | prev | next | size | flags | |     payload     |
+  +------+------+------+-------+ +-----------------+
+    ptr    ptr   size_t   u64        size * byte
+
+  The objects that are too large for the pool are linked into the heap
+  list through this header, the runtime only sees the address of the payload.
+*/
+typedef struct gc_object {
+    struct gc_object* prev;
+    struct gc_object* next;
+    size_t size;
+    u64 flags;
+} gc_object;
+
+#define GC_OBJECT(ptr) ((gc_object*)(ptr) - 1)
+#define GC_PAYLOAD(object) ((void*)((object) + 1))
+// Reached from the roots in the current collection
+#define GC_MARKED (1 << 0)
+// Holds no pointers, its payload is never scanned
+#define GC_ATOMIC (1 << 1)
+
+// A collection is triggered once this many bytes are allocated since the previous one
+#define GC_INITIAL_THRESHOLD (1 << 20)
+// The heap is let grow up to this many times the bytes that survived the previous collection
+#define GC_GROWTH_FACTOR 2
+#define GC_ROOTS_INITIAL_CAPACITY 8
+#define GC_MARK_STACK_INITIAL_CAPACITY 256
+
+#if defined(__GNUC__)
+#define GC_NOINLINE __attribute__((noinline))
+#else
+#define GC_NOINLINE
+#endif
+
+// The conservative scan reads the whole stack, including the redzones and the uninitialized slots
+#if defined(__clang__)
+#define GC_NO_SANITIZE __attribute__((no_sanitize("address", "memory")))
+#elif defined(__GNUC__)
+#define GC_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define GC_NO_SANITIZE
+#endif
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define GC_ADDRESS_SANITIZER
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) && !defined(GC_ADDRESS_SANITIZER)
+#define GC_ADDRESS_SANITIZER
+#endif
+
+// Memcheck is told that the scanned words are defined, a stale stack slot is a valid root candidate
+#if defined(__has_include)
+#if __has_include(<valgrind/memcheck.h>)
+#include <valgrind/memcheck.h>
+#define GC_MAKE_MEM_DEFINED(addr, size) VALGRIND_MAKE_MEM_DEFINED(addr, size)
+#endif
+#endif
+#ifndef GC_MAKE_MEM_DEFINED
+#define GC_MAKE_MEM_DEFINED(addr, size)
+#endif
+
+typedef struct gc_root {
+    void* start;
+    size_t size;
+} gc_root;
+
+// An object that is marked but not scanned yet
+typedef struct gc_range {
+    void* start;
+    size_t size;
+} gc_range;
+
+typedef struct gc_statistics {
+    u64 collections;
+    u64 allocated_bytes;
+    u64 allocated_objects;
+    u64 freed_bytes;
+    u64 freed_objects;
+    u64 live_bytes;
+    u64 live_objects;
+    f64 total_pause;
+    f64 max_pause;
+} gc_statistics;
+
+void gc_set_stack_base(void* stack_base);
+void* gc_alloc(size_t size);
+void* gc_alloc_atomic(size_t size);
+void* gc_alloc_object(size_t size, u64 flags);
+void* gc_realloc(void* ptr, size_t size);
+void gc_free(void* ptr);
+size_t gc_size(void* ptr);
+void gc_add_root(void* start, size_t size);
+void gc_maybe_collect(size_t size);
+void gc_collect();
+void gc_link(gc_object* object);
+void gc_unlink(gc_object* object);
+void gc_sort_objects();
+int gc_compare_objects(const void* a, const void* b);
+gc_object* gc_find_object(i64 addr);
+bool gc_is_live(i64 addr);
+void gc_mark_word(i64 addr);
+void gc_push_pending(void* start, size_t size);
+void gc_mark_range(void* start, void* end);
+void gc_mark_stack();
+void gc_drain_mark_stack();
+void gc_sweep();
+void gc_print_stats();
+
+#endif
@@ -42,9 +42,9 @@ enum IROpCode {
     MOVR, MOVI, FMOV, FMOVR,
     ALLOCAI, REF_ALLOCAI,
     // >>> Load Operations <<<
-    LDR, LDXR, FLDR, FLDXR,
+    LDR, LDXR, LDXI, FLDR, FLDXR, FLDXI,
     // >>> Store Operations <<<
-    STR, STXR, FSTR, FSTXR,
+    STR, STXR, STXI, FSTR, FSTXR, FSTXI,
     // >>> Binary Arithmetic Operations <<<
     ADDR, ADDI,
     SUBR, SUBI,
@@ -56,16 +56,19 @@ enum IROpCode {
     XORR, XORI,
     LSHR, LSHI,
     RSHR, RSHI,
+    // >>> Binary Floating-point Arithmetic Operations <<<
+    FADDR, FSUBR, FMULR, FDIVR,
     // >>> Unary Arithmetic Operations <<<
     NEGR, FNEGR,
     NOTR,
     //  >>> Compare Instructions <<<
     EQR, NER, GTR, LTR, GER, LER,
+    FEQR, FNER, FGTR, FLTR, FGER, FLER,
     // >>> Conversions <<<
     EXTR, TRUNCR,
     // >>> Branch Operations & Jumps <<<
     BEQR, BEQI,
-    JMPI,
+    JMPI, JMPI_FORWARD,
     PATCH,
     // >>> Non-Atomic Instructions <<<
     // Dynamic Arithmetic
@@ -89,8 +92,14 @@ enum IROpCode {
     DYN_STR_TO_BOOL,
     // Dynamic Create New List
     DYN_NEW_LIST, DYN_NEW_DICT,
+    // Dynamic Grow List
+    DYN_LIST_APPEND, DYN_LIST_EXTEND, DYN_LIST_INSERT,
+    // Dynamic Vectorized List Kernels
+    DYN_LIST_KERNEL,
     // Dynamic Composite Helpers
-    DYN_GET_COMP_SIZE,
+    DYN_GET_COMP_SIZE, DYN_COMP_SHARE, DYN_COMP_UNSHARE, DYN_COMP_UNSHARE_ELEMENT,
+    // Dynamic String Helpers
+    DYN_STR_UNSHARE, DYN_STR_APPEND,
     // Dynamic Loop Break
     DYN_BREAK, DYN_BREAK_HANDLE,
     // Debug
@@ -102,22 +111,30 @@ enum IROpCode {
 typedef struct KaosIR KaosIR;
 typedef struct KaosInst KaosInst;
 typedef struct KaosOp KaosOp;
+typedef struct KaosData KaosData;
 
 typedef struct KaosIR {
-    KaosInst** arr;
+    KaosInst* arr;
     i64 capacity;
     i64 size;
     i64 hlt_count;
+    KaosData** data;
+    i64 data_count;
 } KaosIR;
 
-typedef struct KaosInst {
-    i64 op_code;
-    KaosOp* op1;
-    KaosOp* op2;
-    KaosOp* op3;
-    KaosOp* op4;
-    AST* ast;
-} KaosInst;
+// The instructions are kept in a single array that doubles its size when it's full
+#define IR_INITIAL_CAPACITY 1024
+
+// The constant data is allocated in chunks that never move,
+// so the instructions can reference it by address
+#define IR_DATA_CHUNK_SIZE 65536
+
+typedef struct KaosData {
+    byte* arr;
+    i64 capacity;
+    i64 size;
+} KaosData;
+
 
 enum IRType { IR_REG, IR_VAL };
 enum IRValueType { IR_INT, IR_FLOAT, IR_STRING };
@@ -127,15 +144,41 @@ enum IRRegister {
     IR_NUM_REGISTERS
 };
 
+// Registers starting from here are never shifted by the call argument offset,
+// they hold the local variables that are promoted out of their stack slots
+#define IR_PROMOTED_REGISTERS_START 128
+
+// Each call argument shifts the registers by two, so they have to stay below the call target register
+#define IR_MAX_CALL_ARGUMENTS ((IR_PROMOTED_REGISTERS_START - 1 - IR_NUM_REGISTERS) / 2)
+
+/*
+  0            8       12     13           14
+  +------------+-------+------+------------+
+  |   value    |  reg  | type | value type |
+  +------------+-------+------+------------+
+   i64/f64/ptr    u32     u8        u8
+
+  The operands are stored inline in their instruction,
+  the types are kept in a byte each so an operand fits in 16 bytes.
+*/
 typedef struct KaosOp {
-    enum IRType type;
-    enum IRRegister reg;
-    enum IRValueType value_type;
     union IRValue {
         i64 i;
         f64 f;
         byte *s;
     } value;
+    unsigned int reg;
+    unsigned char type;
+    unsigned char value_type;
 } KaosOp;
 
+typedef struct KaosInst {
+    i64 op_code;
+    KaosOp op1;
+    KaosOp op2;
+    KaosOp op3;
+    KaosOp op4;
+    AST* ast;
+} KaosInst;
+
 #endif
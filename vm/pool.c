@@ -0,0 +1,269 @@
+/*
+ * Description: Size-class pool allocator of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "pool.h"
+
+pool_class pool_classes[POOL_CLASS_COUNT] = {{16}, {32}, {64}, {128}, {256}};
+
+// The slabs of all the classes sorted by their addresses, so the interior pointers can be resolved
+pool_slab** pool_slabs = NULL;
+size_t pool_slab_count = 0;
+size_t pool_slab_capacity = 0;
+
+i64 pool_size_class(size_t size)
+{
+    i64 size_class = 0;
+    while (pool_class_size(size_class) < size)
+        size_class++;
+    return size_class;
+}
+
+size_t pool_class_size(i64 size_class)
+{
+    return (size_t)POOL_MIN_OBJECT_SIZE << size_class;
+}
+
+void* pool_alloc(i64 size_class, bool is_atomic)
+{
+    pool_class* pc = &pool_classes[size_class];
+    pool_slab* slab = pc->current;
+    if (slab == NULL || (slab->free_list == NULL && slab->bump + pc->object_size > slab->end)) {
+        // Refill the slabs that have freed objects in them before taking a new one
+        if (pc->partial != NULL) {
+            slab = pc->partial;
+            pc->partial = slab->next_partial;
+            slab->is_partial = false;
+        } else {
+            slab = pool_new_slab(pc);
+        }
+        pc->current = slab;
+    }
+
+    void* ptr;
+    if (slab->free_list != NULL) {
+        ptr = slab->free_list;
+        slab->free_list = *(void**)ptr;
+    } else {
+        ptr = slab->bump;
+        slab->bump += pc->object_size;
+    }
+
+    i64 i = ((byte*)ptr - slab->start) / pc->object_size;
+    POOL_BIT_SET(slab->allocated, i);
+    if (is_atomic) {
+        POOL_BIT_SET(slab->atomic, i);
+    } else {
+        // The garbage left in a reused object would be scanned as if it were pointers
+        POOL_BIT_CLEAR(slab->atomic, i);
+        memset(ptr, 0, pc->object_size);
+    }
+
+    slab->live_objects++;
+    pc->live_objects++;
+    pc->allocations++;
+    return ptr;
+}
+
+void pool_free(pool_slab* slab, void* ptr)
+{
+    pool_class* pc = &pool_classes[pool_size_class(slab->object_size)];
+    i64 i = ((byte*)ptr - slab->start) / slab->object_size;
+    POOL_BIT_CLEAR(slab->allocated, i);
+    POOL_BIT_CLEAR(slab->atomic, i);
+
+    *(void**)ptr = slab->free_list;
+    slab->free_list = ptr;
+    slab->live_objects--;
+    pc->live_objects--;
+
+    if (slab != pc->current)
+        pool_push_partial(pc, slab);
+}
+
+pool_slab* pool_new_slab(pool_class* pc)
+{
+    pool_slab* slab = calloc(1, sizeof(pool_slab));
+    slab->start = malloc(POOL_SLAB_SIZE);
+    slab->bump = slab->start;
+    slab->end = slab->start + POOL_SLAB_SIZE / pc->object_size * pc->object_size;
+    slab->object_size = pc->object_size;
+    slab->next = pc->slabs;
+    pc->slabs = slab;
+    pc->slab_count++;
+
+    if (pool_slab_count == pool_slab_capacity) {
+        pool_slab_capacity = pool_slab_capacity == 0 ? POOL_SLABS_INITIAL_CAPACITY : pool_slab_capacity * 2;
+        pool_slabs = realloc(pool_slabs, pool_slab_capacity * sizeof(pool_slab*));
+    }
+
+    // Keep the slabs sorted
+    size_t i = pool_slab_count;
+    while (i > 0 && pool_slabs[i - 1]->start > slab->start) {
+        pool_slabs[i] = pool_slabs[i - 1];
+        i--;
+    }
+    pool_slabs[i] = slab;
+    pool_slab_count++;
+    return slab;
+}
+
+void pool_release_slab(pool_class* pc, pool_slab* slab)
+{
+    size_t i = 0;
+    while (pool_slabs[i] != slab)
+        i++;
+    memmove(&pool_slabs[i], &pool_slabs[i + 1], (pool_slab_count - i - 1) * sizeof(pool_slab*));
+    pool_slab_count--;
+
+    pc->slab_count--;
+    free(slab->start);
+    free(slab);
+}
+
+void pool_push_partial(pool_class* pc, pool_slab* slab)
+{
+    if (slab->is_partial)
+        return;
+
+    slab->is_partial = true;
+    slab->next_partial = pc->partial;
+    pc->partial = slab;
+}
+
+pool_slab* pool_find_slab(i64 addr)
+{
+    if (pool_slab_count == 0)
+        return NULL;
+    if (addr < (i64)pool_slabs[0]->start || addr >= (i64)pool_slabs[pool_slab_count - 1]->end)
+        return NULL;
+
+    // Find the last slab that starts at or before the address
+    size_t low = 0;
+    size_t high = pool_slab_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((i64)pool_slabs[mid]->start <= addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return NULL;
+
+    pool_slab* slab = pool_slabs[low - 1];
+    if (addr >= (i64)slab->end)
+        return NULL;
+    return slab;
+}
+
+i64 pool_object_index(pool_slab* slab, i64 addr)
+{
+    if (addr >= (i64)slab->bump)
+        return -1;
+
+    i64 i = (addr - (i64)slab->start) / (i64)slab->object_size;
+    if (!POOL_BIT_TEST(slab->allocated, i))
+        return -1;
+    return i;
+}
+
+void pool_sweep(u64* freed_bytes, u64* freed_objects)
+{
+    for (i64 size_class = 0; size_class < POOL_CLASS_COUNT; size_class++) {
+        pool_class* pc = &pool_classes[size_class];
+        pc->partial = NULL;
+
+        pool_slab** link = &pc->slabs;
+        while (*link != NULL) {
+            pool_slab* slab = *link;
+            u64 live_objects = slab->live_objects;
+            pool_sweep_slab(slab);
+
+            u64 freed = live_objects - slab->live_objects;
+            *freed_bytes += freed * pc->object_size;
+            *freed_objects += freed;
+            pc->live_objects -= freed;
+
+            // Give the empty slabs back, except the one that is being filled
+            if (slab->live_objects == 0 && slab != pc->current) {
+                *link = slab->next;
+                pool_release_slab(pc, slab);
+                continue;
+            }
+
+            slab->is_partial = false;
+            if (slab->free_list != NULL && slab != pc->current)
+                pool_push_partial(pc, slab);
+            link = &slab->next;
+        }
+    }
+}
+
+void pool_sweep_slab(pool_slab* slab)
+{
+    size_t used = (slab->bump - slab->start) / slab->object_size;
+    size_t words = (used + 63) / 64;
+
+    slab->live_objects = 0;
+    for (size_t w = 0; w < words; w++) {
+        slab->allocated[w] &= slab->marked[w];
+        slab->atomic[w] &= slab->marked[w];
+        slab->marked[w] = 0;
+        slab->live_objects += POOL_POPCOUNT(slab->allocated[w]);
+    }
+
+    // Chain the free objects in the order of their addresses, so the slab is refilled from its start
+    slab->free_list = NULL;
+    for (size_t i = used; i > 0; i--) {
+        if (POOL_BIT_TEST(slab->allocated, i - 1))
+            continue;
+
+        void* ptr = slab->start + (i - 1) * slab->object_size;
+        *(void**)ptr = slab->free_list;
+        slab->free_list = ptr;
+    }
+}
+
+u64 pool_popcount(u64 x)
+{
+    u64 count = 0;
+    while (x != 0) {
+        x &= x - 1;
+        count++;
+    }
+    return count;
+}
+
+void pool_print_stats()
+{
+    for (i64 size_class = 0; size_class < POOL_CLASS_COUNT; size_class++) {
+        pool_class* pc = &pool_classes[size_class];
+        printf(
+            "    pool %zu bytes: %llu live objects (%llu bytes) in %llu slabs, %llu allocations\n",
+            pc->object_size,
+            pc->live_objects,
+            pc->live_objects * pc->object_size,
+            pc->slab_count,
+            pc->allocations
+        );
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Description: Size-class pool allocator of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "types.h"
+
+/*
+  start                                    bump                 end
+  +--------+--------+--------+ ... +--------+ +-----------------+
+  | object | object | object |     | object | |     unused      |
+  +--------+--------+--------+ ... +--------+ +-----------------+
+    size     size     size           size
+
+  A slab holds the objects of a single size class back to back, without
+  a header per object. The state of an object is kept in the bitmaps of
+  its slab, the freed objects are chained through their first word.
+*/
+#define POOL_SLAB_SIZE (64 * 1024)
+#define POOL_MIN_OBJECT_SIZE 16
+// The size classes are 16, 32, 64, 128 and 256 bytes
+#define POOL_CLASS_COUNT 5
+#define POOL_MAX_OBJECT_SIZE (POOL_MIN_OBJECT_SIZE << (POOL_CLASS_COUNT - 1))
+#define POOL_BITMAP_WORDS (POOL_SLAB_SIZE / POOL_MIN_OBJECT_SIZE / 64)
+#define POOL_SLABS_INITIAL_CAPACITY 16
+
+#define POOL_BIT_TEST(bitmap, i) ((bitmap)[(i) / 64] & (1ULL << ((i) % 64)))
+#define POOL_BIT_SET(bitmap, i) ((bitmap)[(i) / 64] |= (1ULL << ((i) % 64)))
+#define POOL_BIT_CLEAR(bitmap, i) ((bitmap)[(i) / 64] &= ~(1ULL << ((i) % 64)))
+
+#if defined(__GNUC__)
+#define POOL_POPCOUNT(x) __builtin_popcountll(x)
+#else
+#define POOL_POPCOUNT(x) pool_popcount(x)
+#endif
+
+typedef struct pool_slab {
+    byte* start;
+    byte* bump;
+    byte* end;
+    size_t object_size;
+    void* free_list;
+    struct pool_slab* next;
+    struct pool_slab* next_partial;
+    bool is_partial;
+    u64 live_objects;
+    u64 allocated[POOL_BITMAP_WORDS];
+    u64 marked[POOL_BITMAP_WORDS];
+    u64 atomic[POOL_BITMAP_WORDS];
+} pool_slab;
+
+typedef struct pool_class {
+    size_t object_size;
+    pool_slab* slabs;
+    // The slab that is being filled and the others that have freed objects in them
+    pool_slab* current;
+    pool_slab* partial;
+    u64 live_objects;
+    u64 slab_count;
+    u64 allocations;
+} pool_class;
+
+i64 pool_size_class(size_t size);
+size_t pool_class_size(i64 size_class);
+void* pool_alloc(i64 size_class, bool is_atomic);
+void pool_free(pool_slab* slab, void* ptr);
+pool_slab* pool_new_slab(pool_class* pc);
+void pool_release_slab(pool_class* pc, pool_slab* slab);
+void pool_push_partial(pool_class* pc, pool_slab* slab);
+pool_slab* pool_find_slab(i64 addr);
+i64 pool_object_index(pool_slab* slab, i64 addr);
+void pool_sweep(u64* freed_bytes, u64* freed_objects);
+void pool_sweep_slab(pool_slab* slab);
+u64 pool_popcount(u64 x);
+void pool_print_stats();
+
+#endif
@@ -0,0 +1,835 @@
+/*
+ * Description: Vectorized list kernels of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "simd.h"
+#include "../interpreter/errors.h"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+enum SimdLevel simd_level = SIMD_LEVEL_UNKNOWN;
+
+// The result of a kernel is handed out in this cell, it's only valid until the next kernel call
+i64 simd_result_cell[2];
+
+// The kernel that is running, its name and call site go into the errors
+i64 simd_kernel = SIMD_SUM;
+char* simd_kernel_names[] = {
+    "sum", "product", "min", "max", "mean", "dot",
+    "add", "sub", "mul", "div",
+    "eq", "ne", "gt", "lt", "ge", "le"
+};
+
+extern i64 ast_ref;
+
+enum SimdLevel simd_detect()
+{
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_LEVEL_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SIMD_LEVEL_SSE2;
+#endif
+    return SIMD_LEVEL_SCALAR;
+}
+
+i64 simd_run_kernel(i64 kernel, i64 ast, i64 addr, i64 r0, i64 r1, f64 fr1)
+{
+    if (simd_level == SIMD_LEVEL_UNKNOWN)
+        simd_level = simd_detect();
+
+    simd_kernel = kernel;
+    ast_ref = ast;
+    simd_view x = simd_view_list(addr);
+    i64 result = 0;
+
+    switch (kernel) {
+    case SIMD_SUM:
+    case SIMD_PRODUCT:
+    case SIMD_MIN:
+    case SIMD_MAX:
+    case SIMD_MEAN:
+        result = simd_reduce(kernel, &x);
+        break;
+    default: {
+        // A scalar operand is broadcast to the length of the list
+        if (r0 != V_LIST && !simd_is_numeric(r0)) {
+            simd_view_free(&x);
+            throw_error(E_ILLEGAL_VARIABLE_TYPE_FOR_FUNCTION_PARAMETER, getValueTypeName(r0), simd_kernel_names[kernel]);
+        }
+        simd_view y = r0 == V_LIST ? simd_view_list(r1) : simd_view_scalar(r0, r1, fr1, x.len);
+        if (y.len != x.len) {
+            simd_view_free(&x);
+            simd_view_free(&y);
+            throw_error(E_LIST_LENGTH_MISMATCH, simd_kernel_names[kernel], NULL, x.len, y.len);
+        }
+        if (kernel == SIMD_DOT)
+            result = simd_dot(&x, &y);
+        else if (kernel <= SIMD_DIV)
+            result = simd_arith(kernel, &x, &y);
+        else
+            result = simd_compare(kernel, &x, &y);
+        simd_view_free(&y);
+        break;
+    }
+    }
+
+    simd_view_free(&x);
+    return result;
+}
+
+i64 simd_result(i64 type, i64 val)
+{
+    simd_result_cell[0] = type;
+    simd_result_cell[1] = val;
+    return (i64)simd_result_cell;
+}
+
+i64 simd_result_float(f64 f)
+{
+    simd_result_cell[0] = V_FLOAT;
+    memcpy(&simd_result_cell[1], &f, sizeof(f64));
+    return (i64)simd_result_cell;
+}
+
+simd_view simd_view_list(i64 addr)
+{
+    simd_view view;
+    view.type = V_INT;
+    view.len = *(size_t*)addr;
+    view.data = cpu_list_elements(addr);
+    view.is_owned = false;
+
+    // The unboxed numeric lists are used in place, the booleans count as 0 and 1
+    i64 element_type = *(i64*)(addr + CPU_LIST_ELEMENT_TYPE_OFFSET);
+    switch (element_type) {
+    case V_BOOL:
+    case V_INT:
+        return view;
+    case V_FLOAT:
+        view.type = V_FLOAT;
+        return view;
+    default:
+        break;
+    }
+
+    // Gather the values behind the refs, a single float makes it a list of floats
+    i64* elements = (i64*)view.data;
+    for (size_t i = 0; i < view.len; i++) {
+        if (element_type == V_ANY && *(i64*)elements[i] == V_FLOAT)
+            view.type = V_FLOAT;
+    }
+
+    view.data = malloc((view.len + 1) * sizeof(i64));
+    view.is_owned = true;
+    for (size_t i = 0; i < view.len; i++) {
+        i64 type = element_type == V_ANY ? *(i64*)elements[i] : element_type;
+        i64 val = element_type == V_ANY ? *(i64*)(elements[i] + sizeof(i64)) : elements[i];
+        if (!simd_is_numeric(type)) {
+            simd_view_free(&view);
+            throw_error(E_NOT_A_NUMERIC_LIST, simd_kernel_names[simd_kernel], NULL, i);
+        }
+
+        if (view.type == V_INT)
+            ((i64*)view.data)[i] = val;
+        else if (type == V_FLOAT)
+            memcpy(&((f64*)view.data)[i], &val, sizeof(f64));
+        else
+            ((f64*)view.data)[i] = (f64)val;
+    }
+    return view;
+}
+
+simd_view simd_view_scalar(i64 r0, i64 r1, f64 fr1, size_t len)
+{
+    simd_view view;
+    view.type = r0 == V_FLOAT ? V_FLOAT : V_INT;
+    view.len = len;
+    view.data = malloc((len + 1) * sizeof(i64));
+    view.is_owned = true;
+
+    for (size_t i = 0; i < len; i++) {
+        if (view.type == V_FLOAT)
+            ((f64*)view.data)[i] = fr1;
+        else
+            ((i64*)view.data)[i] = r1;
+    }
+    return view;
+}
+
+bool simd_is_numeric(i64 type)
+{
+    // The booleans count as 0 and 1
+    return type == V_BOOL || type == V_INT || type == V_FLOAT;
+}
+
+void simd_view_to_float(simd_view* view)
+{
+    if (view->type == V_FLOAT)
+        return;
+
+    f64* data = (f64*)malloc((view->len + 1) * sizeof(f64));
+    for (size_t i = 0; i < view->len; i++)
+        data[i] = (f64)((i64*)view->data)[i];
+
+    simd_view_free(view);
+    view->type = V_FLOAT;
+    view->data = data;
+    view->is_owned = true;
+}
+
+void simd_view_free(simd_view* view)
+{
+    if (view->is_owned)
+        free(view->data);
+    view->is_owned = false;
+}
+
+i64 simd_reduce(i64 kernel, simd_view* view)
+{
+    // The sum and the product of an empty list are their identities, the rest are undefined
+    if (view->len == 0 && kernel != SIMD_SUM && kernel != SIMD_PRODUCT) {
+        simd_view_free(view);
+        throw_error(E_EMPTY_LIST, simd_kernel_names[kernel]);
+    }
+
+    if (kernel == SIMD_MEAN) {
+        simd_view_to_float(view);
+        return simd_result_float(simd_f64_sum((f64*)view->data, view->len) / view->len);
+    }
+
+    if (view->type == V_FLOAT) {
+        f64* a = (f64*)view->data;
+        switch (kernel) {
+        case SIMD_SUM:
+            return simd_result_float(simd_f64_sum(a, view->len));
+        case SIMD_PRODUCT:
+            return simd_result_float(simd_f64_product(a, view->len));
+        default:
+            return simd_result_float(simd_f64_min_max(a, view->len, kernel == SIMD_MAX));
+        }
+    }
+
+    i64* a = (i64*)view->data;
+    switch (kernel) {
+    case SIMD_SUM:
+        return simd_result(V_INT, simd_i64_sum(a, view->len));
+    case SIMD_PRODUCT:
+        return simd_result(V_INT, simd_i64_product(a, view->len));
+    default:
+        return simd_result(V_INT, simd_i64_min_max(a, view->len, kernel == SIMD_MAX));
+    }
+}
+
+i64 simd_dot(simd_view* x, simd_view* y)
+{
+    size_t n = x->len;
+    if (x->type == V_INT && y->type == V_INT)
+        return simd_result(V_INT, simd_i64_dot((i64*)x->data, (i64*)y->data, n));
+
+    simd_view_to_float(x);
+    simd_view_to_float(y);
+    return simd_result_float(simd_f64_dot((f64*)x->data, (f64*)y->data, n));
+}
+
+i64 simd_arith(i64 kernel, simd_view* x, simd_view* y)
+{
+    size_t n = x->len;
+    if (x->type == V_INT && y->type == V_INT) {
+        i64 addr = cpu_new_unboxed_list(V_INT, n);
+        simd_i64_arith(kernel, cpu_list_elements(addr), (i64*)x->data, (i64*)y->data, n);
+        return simd_result(V_LIST, addr);
+    }
+
+    simd_view_to_float(x);
+    simd_view_to_float(y);
+    i64 addr = cpu_new_unboxed_list(V_FLOAT, n);
+    simd_f64_arith(kernel, (f64*)cpu_list_elements(addr), (f64*)x->data, (f64*)y->data, n);
+    return simd_result(V_LIST, addr);
+}
+
+i64 simd_compare(i64 kernel, simd_view* x, simd_view* y)
+{
+    size_t n = x->len;
+    i64 addr = cpu_new_unboxed_list(V_BOOL, n);
+    if (x->type == V_INT && y->type == V_INT) {
+        simd_i64_compare(kernel, cpu_list_elements(addr), (i64*)x->data, (i64*)y->data, n);
+        return simd_result(V_LIST, addr);
+    }
+
+    simd_view_to_float(x);
+    simd_view_to_float(y);
+    simd_f64_compare(kernel, cpu_list_elements(addr), (f64*)x->data, (f64*)y->data, n);
+    return simd_result(V_LIST, addr);
+}
+
+i64 simd_i64_sum(i64* a, size_t n)
+{
+    size_t i = 0;
+    i64 sum = 0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        sum = simd_i64_sum_avx2(a, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        sum = simd_i64_sum_sse2(a, n, &i);
+#endif
+    for (; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+i64 simd_i64_product(i64* a, size_t n)
+{
+    // There is no packed 64-bit multiplication below AVX-512
+    i64 product = 1;
+    for (size_t i = 0; i < n; i++)
+        product *= a[i];
+    return product;
+}
+
+i64 simd_i64_min_max(i64* a, size_t n, bool is_max)
+{
+    size_t i = 1;
+    i64 result = a[0];
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        result = simd_i64_min_max_avx2(a, n, is_max, &i);
+#endif
+    for (; i < n; i++) {
+        if (is_max ? a[i] > result : a[i] < result)
+            result = a[i];
+    }
+    return result;
+}
+
+i64 simd_i64_dot(i64* a, i64* b, size_t n)
+{
+    i64 dot = 0;
+    for (size_t i = 0; i < n; i++)
+        dot += a[i] * b[i];
+    return dot;
+}
+
+void simd_i64_arith(i64 kernel, i64* out, i64* a, i64* b, size_t n)
+{
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        simd_i64_arith_avx2(kernel, out, a, b, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        simd_i64_arith_sse2(kernel, out, a, b, n, &i);
+#endif
+    for (; i < n; i++) {
+        switch (kernel) {
+        case SIMD_ADD:
+            out[i] = a[i] + b[i];
+            break;
+        case SIMD_SUB:
+            out[i] = a[i] - b[i];
+            break;
+        case SIMD_MUL:
+            out[i] = a[i] * b[i];
+            break;
+        default:
+            out[i] = a[i] / b[i];
+            break;
+        }
+    }
+}
+
+void simd_i64_compare(i64 kernel, i64* out, i64* a, i64* b, size_t n)
+{
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        simd_i64_compare_avx2(kernel, out, a, b, n, &i);
+#endif
+    for (; i < n; i++) {
+        switch (kernel) {
+        case SIMD_EQ:
+            out[i] = a[i] == b[i];
+            break;
+        case SIMD_NE:
+            out[i] = a[i] != b[i];
+            break;
+        case SIMD_GT:
+            out[i] = a[i] > b[i];
+            break;
+        case SIMD_LT:
+            out[i] = a[i] < b[i];
+            break;
+        case SIMD_GE:
+            out[i] = a[i] >= b[i];
+            break;
+        default:
+            out[i] = a[i] <= b[i];
+            break;
+        }
+    }
+}
+
+f64 simd_f64_sum(f64* a, size_t n)
+{
+    size_t i = 0;
+    f64 sum = 0.0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        sum = simd_f64_sum_avx2(a, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        sum = simd_f64_sum_sse2(a, n, &i);
+#endif
+    for (; i < n; i++)
+        sum += a[i];
+    return sum;
+}
+
+f64 simd_f64_product(f64* a, size_t n)
+{
+    size_t i = 0;
+    f64 product = 1.0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        product = simd_f64_product_avx2(a, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        product = simd_f64_product_sse2(a, n, &i);
+#endif
+    for (; i < n; i++)
+        product *= a[i];
+    return product;
+}
+
+f64 simd_f64_min_max(f64* a, size_t n, bool is_max)
+{
+    size_t i = 1;
+    f64 result = a[0];
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        result = simd_f64_min_max_avx2(a, n, is_max, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        result = simd_f64_min_max_sse2(a, n, is_max, &i);
+#endif
+    for (; i < n; i++) {
+        if (is_max ? a[i] > result : a[i] < result)
+            result = a[i];
+    }
+    return result;
+}
+
+f64 simd_f64_dot(f64* a, f64* b, size_t n)
+{
+    size_t i = 0;
+    f64 dot = 0.0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        dot = simd_f64_dot_avx2(a, b, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        dot = simd_f64_dot_sse2(a, b, n, &i);
+#endif
+    for (; i < n; i++)
+        dot += a[i] * b[i];
+    return dot;
+}
+
+void simd_f64_arith(i64 kernel, f64* out, f64* a, f64* b, size_t n)
+{
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        simd_f64_arith_avx2(kernel, out, a, b, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        simd_f64_arith_sse2(kernel, out, a, b, n, &i);
+#endif
+    for (; i < n; i++) {
+        switch (kernel) {
+        case SIMD_ADD:
+            out[i] = a[i] + b[i];
+            break;
+        case SIMD_SUB:
+            out[i] = a[i] - b[i];
+            break;
+        case SIMD_MUL:
+            out[i] = a[i] * b[i];
+            break;
+        default:
+            out[i] = a[i] / b[i];
+            break;
+        }
+    }
+}
+
+void simd_f64_compare(i64 kernel, i64* out, f64* a, f64* b, size_t n)
+{
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (simd_level == SIMD_LEVEL_AVX2)
+        simd_f64_compare_avx2(kernel, out, a, b, n, &i);
+    else if (simd_level == SIMD_LEVEL_SSE2)
+        simd_f64_compare_sse2(kernel, out, a, b, n, &i);
+#endif
+    for (; i < n; i++) {
+        switch (kernel) {
+        case SIMD_EQ:
+            out[i] = a[i] == b[i];
+            break;
+        case SIMD_NE:
+            out[i] = a[i] != b[i];
+            break;
+        case SIMD_GT:
+            out[i] = a[i] > b[i];
+            break;
+        case SIMD_LT:
+            out[i] = a[i] < b[i];
+            break;
+        case SIMD_GE:
+            out[i] = a[i] >= b[i];
+            break;
+        default:
+            out[i] = a[i] <= b[i];
+            break;
+        }
+    }
+}
+
+#ifdef SIMD_X86
+SIMD_TARGET_SSE2 i64 simd_i64_sum_sse2(i64* a, size_t n, size_t* i)
+{
+    __m128i acc = _mm_setzero_si128();
+    for (; *i + 2 <= n; *i += 2)
+        acc = _mm_add_epi64(acc, _mm_loadu_si128((__m128i*)&a[*i]));
+
+    i64 lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return lanes[0] + lanes[1];
+}
+
+SIMD_TARGET_AVX2 i64 simd_i64_sum_avx2(i64* a, size_t n, size_t* i)
+{
+    __m256i acc = _mm256_setzero_si256();
+    for (; *i + 4 <= n; *i += 4)
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256((__m256i*)&a[*i]));
+
+    i64 lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SIMD_TARGET_AVX2 i64 simd_i64_min_max_avx2(i64* a, size_t n, bool is_max, size_t* i)
+{
+    i64 result = a[0];
+    if (n < 4)
+        return result;
+
+    __m256i acc = _mm256_loadu_si256((__m256i*)a);
+    for (*i = 4; *i + 4 <= n; *i += 4) {
+        __m256i v = _mm256_loadu_si256((__m256i*)&a[*i]);
+        // Take the lanes of `v` where it's beyond the accumulator
+        __m256i mask = is_max ? _mm256_cmpgt_epi64(v, acc) : _mm256_cmpgt_epi64(acc, v);
+        acc = _mm256_blendv_epi8(acc, v, mask);
+    }
+
+    i64 lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, acc);
+    for (int j = 0; j < 4; j++) {
+        if (is_max ? lanes[j] > result : lanes[j] < result)
+            result = lanes[j];
+    }
+    return result;
+}
+
+SIMD_TARGET_SSE2 void simd_i64_arith_sse2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i)
+{
+    if (kernel != SIMD_ADD && kernel != SIMD_SUB)
+        return;
+
+    for (; *i + 2 <= n; *i += 2) {
+        __m128i x = _mm_loadu_si128((__m128i*)&a[*i]);
+        __m128i y = _mm_loadu_si128((__m128i*)&b[*i]);
+        __m128i r = kernel == SIMD_ADD ? _mm_add_epi64(x, y) : _mm_sub_epi64(x, y);
+        _mm_storeu_si128((__m128i*)&out[*i], r);
+    }
+}
+
+SIMD_TARGET_AVX2 void simd_i64_arith_avx2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i)
+{
+    if (kernel != SIMD_ADD && kernel != SIMD_SUB)
+        return;
+
+    for (; *i + 4 <= n; *i += 4) {
+        __m256i x = _mm256_loadu_si256((__m256i*)&a[*i]);
+        __m256i y = _mm256_loadu_si256((__m256i*)&b[*i]);
+        __m256i r = kernel == SIMD_ADD ? _mm256_add_epi64(x, y) : _mm256_sub_epi64(x, y);
+        _mm256_storeu_si256((__m256i*)&out[*i], r);
+    }
+}
+
+SIMD_TARGET_AVX2 void simd_i64_compare_avx2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i)
+{
+    __m256i ones = _mm256_set1_epi64x(-1);
+    for (; *i + 4 <= n; *i += 4) {
+        __m256i x = _mm256_loadu_si256((__m256i*)&a[*i]);
+        __m256i y = _mm256_loadu_si256((__m256i*)&b[*i]);
+        __m256i mask;
+        switch (kernel) {
+        case SIMD_EQ:
+            mask = _mm256_cmpeq_epi64(x, y);
+            break;
+        case SIMD_NE:
+            mask = _mm256_xor_si256(_mm256_cmpeq_epi64(x, y), ones);
+            break;
+        case SIMD_GT:
+            mask = _mm256_cmpgt_epi64(x, y);
+            break;
+        case SIMD_LT:
+            mask = _mm256_cmpgt_epi64(y, x);
+            break;
+        case SIMD_GE:
+            mask = _mm256_xor_si256(_mm256_cmpgt_epi64(y, x), ones);
+            break;
+        default:
+            mask = _mm256_xor_si256(_mm256_cmpgt_epi64(x, y), ones);
+            break;
+        }
+        // All ones in a lane become 1
+        _mm256_storeu_si256((__m256i*)&out[*i], _mm256_srli_epi64(mask, 63));
+    }
+}
+
+SIMD_TARGET_SSE2 f64 simd_f64_sum_sse2(f64* a, size_t n, size_t* i)
+{
+    __m128d acc = _mm_setzero_pd();
+    for (; *i + 2 <= n; *i += 2)
+        acc = _mm_add_pd(acc, _mm_loadu_pd(&a[*i]));
+
+    f64 lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    return lanes[0] + lanes[1];
+}
+
+SIMD_TARGET_AVX2 f64 simd_f64_sum_avx2(f64* a, size_t n, size_t* i)
+{
+    __m256d acc = _mm256_setzero_pd();
+    for (; *i + 4 <= n; *i += 4)
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(&a[*i]));
+
+    f64 lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SIMD_TARGET_SSE2 f64 simd_f64_product_sse2(f64* a, size_t n, size_t* i)
+{
+    __m128d acc = _mm_set1_pd(1.0);
+    for (; *i + 2 <= n; *i += 2)
+        acc = _mm_mul_pd(acc, _mm_loadu_pd(&a[*i]));
+
+    f64 lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    return lanes[0] * lanes[1];
+}
+
+SIMD_TARGET_AVX2 f64 simd_f64_product_avx2(f64* a, size_t n, size_t* i)
+{
+    __m256d acc = _mm256_set1_pd(1.0);
+    for (; *i + 4 <= n; *i += 4)
+        acc = _mm256_mul_pd(acc, _mm256_loadu_pd(&a[*i]));
+
+    f64 lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    return lanes[0] * lanes[1] * lanes[2] * lanes[3];
+}
+
+SIMD_TARGET_SSE2 f64 simd_f64_min_max_sse2(f64* a, size_t n, bool is_max, size_t* i)
+{
+    f64 result = a[0];
+    if (n < 2)
+        return result;
+
+    __m128d acc = _mm_loadu_pd(a);
+    for (*i = 2; *i + 2 <= n; *i += 2) {
+        __m128d v = _mm_loadu_pd(&a[*i]);
+        acc = is_max ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+    }
+
+    f64 lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    for (int j = 0; j < 2; j++) {
+        if (is_max ? lanes[j] > result : lanes[j] < result)
+            result = lanes[j];
+    }
+    return result;
+}
+
+SIMD_TARGET_AVX2 f64 simd_f64_min_max_avx2(f64* a, size_t n, bool is_max, size_t* i)
+{
+    f64 result = a[0];
+    if (n < 4)
+        return result;
+
+    __m256d acc = _mm256_loadu_pd(a);
+    for (*i = 4; *i + 4 <= n; *i += 4) {
+        __m256d v = _mm256_loadu_pd(&a[*i]);
+        acc = is_max ? _mm256_max_pd(acc, v) : _mm256_min_pd(acc, v);
+    }
+
+    f64 lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    for (int j = 0; j < 4; j++) {
+        if (is_max ? lanes[j] > result : lanes[j] < result)
+            result = lanes[j];
+    }
+    return result;
+}
+
+SIMD_TARGET_SSE2 f64 simd_f64_dot_sse2(f64* a, f64* b, size_t n, size_t* i)
+{
+    __m128d acc = _mm_setzero_pd();
+    for (; *i + 2 <= n; *i += 2)
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(&a[*i]), _mm_loadu_pd(&b[*i])));
+
+    f64 lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    return lanes[0] + lanes[1];
+}
+
+SIMD_TARGET_AVX2 f64 simd_f64_dot_avx2(f64* a, f64* b, size_t n, size_t* i)
+{
+    __m256d acc = _mm256_setzero_pd();
+    for (; *i + 4 <= n; *i += 4)
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(&a[*i]), _mm256_loadu_pd(&b[*i])));
+
+    f64 lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SIMD_TARGET_SSE2 void simd_f64_arith_sse2(i64 kernel, f64* out, f64* a, f64* b, size_t n, size_t* i)
+{
+    for (; *i + 2 <= n; *i += 2) {
+        __m128d x = _mm_loadu_pd(&a[*i]);
+        __m128d y = _mm_loadu_pd(&b[*i]);
+        __m128d r;
+        switch (kernel) {
+        case SIMD_ADD:
+            r = _mm_add_pd(x, y);
+            break;
+        case SIMD_SUB:
+            r = _mm_sub_pd(x, y);
+            break;
+        case SIMD_MUL:
+            r = _mm_mul_pd(x, y);
+            break;
+        default:
+            r = _mm_div_pd(x, y);
+            break;
+        }
+        _mm_storeu_pd(&out[*i], r);
+    }
+}
+
+SIMD_TARGET_AVX2 void simd_f64_arith_avx2(i64 kernel, f64* out, f64* a, f64* b, size_t n, size_t* i)
+{
+    for (; *i + 4 <= n; *i += 4) {
+        __m256d x = _mm256_loadu_pd(&a[*i]);
+        __m256d y = _mm256_loadu_pd(&b[*i]);
+        __m256d r;
+        switch (kernel) {
+        case SIMD_ADD:
+            r = _mm256_add_pd(x, y);
+            break;
+        case SIMD_SUB:
+            r = _mm256_sub_pd(x, y);
+            break;
+        case SIMD_MUL:
+            r = _mm256_mul_pd(x, y);
+            break;
+        default:
+            r = _mm256_div_pd(x, y);
+            break;
+        }
+        _mm256_storeu_pd(&out[*i], r);
+    }
+}
+
+SIMD_TARGET_SSE2 void simd_f64_compare_sse2(i64 kernel, i64* out, f64* a, f64* b, size_t n, size_t* i)
+{
+    for (; *i + 2 <= n; *i += 2) {
+        __m128d x = _mm_loadu_pd(&a[*i]);
+        __m128d y = _mm_loadu_pd(&b[*i]);
+        __m128d mask;
+        switch (kernel) {
+        case SIMD_EQ:
+            mask = _mm_cmpeq_pd(x, y);
+            break;
+        case SIMD_NE:
+            mask = _mm_cmpneq_pd(x, y);
+            break;
+        case SIMD_GT:
+            mask = _mm_cmpgt_pd(x, y);
+            break;
+        case SIMD_LT:
+            mask = _mm_cmplt_pd(x, y);
+            break;
+        case SIMD_GE:
+            mask = _mm_cmpge_pd(x, y);
+            break;
+        default:
+            mask = _mm_cmple_pd(x, y);
+            break;
+        }
+        // All ones in a lane become 1
+        _mm_storeu_si128((__m128i*)&out[*i], _mm_srli_epi64(_mm_castpd_si128(mask), 63));
+    }
+}
+
+SIMD_TARGET_AVX2 void simd_f64_compare_avx2(i64 kernel, i64* out, f64* a, f64* b, size_t n, size_t* i)
+{
+    for (; *i + 4 <= n; *i += 4) {
+        __m256d x = _mm256_loadu_pd(&a[*i]);
+        __m256d y = _mm256_loadu_pd(&b[*i]);
+        __m256d mask;
+        switch (kernel) {
+        case SIMD_EQ:
+            mask = _mm256_cmp_pd(x, y, _CMP_EQ_OQ);
+            break;
+        case SIMD_NE:
+            mask = _mm256_cmp_pd(x, y, _CMP_NEQ_UQ);
+            break;
+        case SIMD_GT:
+            mask = _mm256_cmp_pd(x, y, _CMP_GT_OQ);
+            break;
+        case SIMD_LT:
+            mask = _mm256_cmp_pd(x, y, _CMP_LT_OQ);
+            break;
+        case SIMD_GE:
+            mask = _mm256_cmp_pd(x, y, _CMP_GE_OQ);
+            break;
+        default:
+            mask = _mm256_cmp_pd(x, y, _CMP_LE_OQ);
+            break;
+        }
+        // All ones in a lane become 1
+        _mm256_storeu_si256((__m256i*)&out[*i], _mm256_srli_epi64(_mm256_castpd_si256(mask), 63));
+    }
+}
+#endif
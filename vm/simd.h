@@ -0,0 +1,109 @@
+/*
+ * Description: Vectorized list kernels of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "cpu.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+enum SimdLevel {
+    SIMD_LEVEL_UNKNOWN,
+    SIMD_LEVEL_SCALAR,
+    SIMD_LEVEL_SSE2,
+    SIMD_LEVEL_AVX2
+};
+
+enum SimdKernel {
+    // Reductions
+    SIMD_SUM, SIMD_PRODUCT, SIMD_MIN, SIMD_MAX, SIMD_MEAN, SIMD_DOT,
+    // Element-wise arithmetic with a list or a scalar
+    SIMD_ADD, SIMD_SUB, SIMD_MUL, SIMD_DIV,
+    // Element-wise comparison masks with a list or a scalar
+    SIMD_EQ, SIMD_NE, SIMD_GT, SIMD_LT, SIMD_GE, SIMD_LE
+};
+
+// The numeric contents of a list, either borrowed from an unboxed list or gathered from the refs
+typedef struct simd_view {
+    i64 type;
+    size_t len;
+    void* data;
+    bool is_owned;
+} simd_view;
+
+enum SimdLevel simd_detect();
+i64 simd_run_kernel(i64 kernel, i64 ast, i64 addr, i64 r0, i64 r1, f64 fr1);
+i64 simd_result(i64 type, i64 val);
+i64 simd_result_float(f64 f);
+
+simd_view simd_view_list(i64 addr);
+simd_view simd_view_scalar(i64 r0, i64 r1, f64 fr1, size_t len);
+bool simd_is_numeric(i64 type);
+void simd_view_to_float(simd_view* view);
+void simd_view_free(simd_view* view);
+
+i64 simd_reduce(i64 kernel, simd_view* view);
+i64 simd_dot(simd_view* x, simd_view* y);
+i64 simd_arith(i64 kernel, simd_view* x, simd_view* y);
+i64 simd_compare(i64 kernel, simd_view* x, simd_view* y);
+
+i64 simd_i64_sum(i64* a, size_t n);
+i64 simd_i64_product(i64* a, size_t n);
+i64 simd_i64_min_max(i64* a, size_t n, bool is_max);
+i64 simd_i64_dot(i64* a, i64* b, size_t n);
+void simd_i64_arith(i64 kernel, i64* out, i64* a, i64* b, size_t n);
+void simd_i64_compare(i64 kernel, i64* out, i64* a, i64* b, size_t n);
+f64 simd_f64_sum(f64* a, size_t n);
+f64 simd_f64_product(f64* a, size_t n);
+f64 simd_f64_min_max(f64* a, size_t n, bool is_max);
+f64 simd_f64_dot(f64* a, f64* b, size_t n);
+void simd_f64_arith(i64 kernel, f64* out, f64* a, f64* b, size_t n);
+void simd_f64_compare(i64 kernel, i64* out, f64* a, f64* b, size_t n);
+
+#ifdef SIMD_X86
+// The vectorized loops process the leading part of the arrays and report where they stopped
+SIMD_TARGET_SSE2 i64 simd_i64_sum_sse2(i64* a, size_t n, size_t* i);
+SIMD_TARGET_AVX2 i64 simd_i64_sum_avx2(i64* a, size_t n, size_t* i);
+SIMD_TARGET_AVX2 i64 simd_i64_min_max_avx2(i64* a, size_t n, bool is_max, size_t* i);
+SIMD_TARGET_SSE2 void simd_i64_arith_sse2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i);
+SIMD_TARGET_AVX2 void simd_i64_arith_avx2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i);
+SIMD_TARGET_AVX2 void simd_i64_compare_avx2(i64 kernel, i64* out, i64* a, i64* b, size_t n, size_t* i);
+SIMD_TARGET_SSE2 f64 simd_f64_sum_sse2(f64* a, size_t n, size_t* i);
+SIMD_TARGET_AVX2 f64 simd_f64_sum_avx2(f64* a, size_t n, size_t* i);
+SIMD_TARGET_SSE2 f64 simd_f64_product_sse2(f64* a, size_t n, size_t* i);
+SIMD_TARGET_AVX2 f64 simd_f64_product_avx2(f64* a, size_t n, size_t* i);
+SIMD_TARGET_SSE2 f64 simd_f64_min_max_sse2(f64* a, size_t n, bool is_max, size_t* i);
+SIMD_TARGET_AVX2 f64 simd_f64_min_max_avx2(f64* a, size_t n, bool is_max, size_t* i);
+SIMD_TARGET_SSE2 f64 simd_f64_dot_sse2(f64* a, f64* b, size_t n, size_t* i);
+SIMD_TARGET_AVX2 f64 simd_f64_dot_avx2(f64* a, f64* b, size_t n, size_t* i);
+SIMD_TARGET_SSE2 void simd_f64_arith_sse2(i64 kernel, f64* out, f64* a, f64* b, size_t n, size_t* i);
+SIMD_TARGET_AVX2 void simd_f64_arith_avx2(i64 kernel, f64* out, f64* a, f64* b, size_t n, size_t* i);
+SIMD_TARGET_SSE2 void simd_f64_compare_sse2(i64 kernel, i64* out, f64* a, f64* b, size_t n, size_t* i);
+SIMD_TARGET_AVX2 void simd_f64_compare_avx2(i64 kernel, i64* out, f64* a, f64* b, size_t n, size_t* i);
+#endif
+
+#endif
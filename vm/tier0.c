@@ -0,0 +1,946 @@
+/*
+ * Description: Tier 0 IR interpreter of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#include "tier0.h"
+#include "simd.h"
+
+extern jit_function_table* function_table;
+extern cpu* running_cpu;
+extern bool break_current_loop;
+
+// Instruction indexes of the labels and the patches, looked up by their IDs
+i64* tier0_label_ic = NULL;
+i64 tier0_label_count = 0;
+i64* tier0_patch_ic = NULL;
+i64 tier0_patch_count = 0;
+
+#define TIER0_DYN_FLOAT_OPERANDS() \
+    /* Cast the operand that is not a float, the same way the JIT does */ \
+    if (r[0] != V_FLOAT) { \
+        r[0] = V_FLOAT; \
+        fr[1] = (f64)r[1]; \
+    } \
+    if (r[4] != V_FLOAT) { \
+        fr[0] = fr[1]; \
+        fr[2] = (f64)r[5]; \
+    } \
+
+#define TIER0_DYN_BINARY_ARITH(_op) \
+    if (r[0] == V_FLOAT || r[4] == V_FLOAT) { \
+        TIER0_DYN_FLOAT_OPERANDS() \
+        fr[1] = fr[1] _op fr[2]; \
+    } else { \
+        r[1] = r[1] _op r[5]; \
+    } \
+
+#define TIER0_DYN_BINARY_COMPARISON(_op) \
+    if (r[0] == V_FLOAT || r[4] == V_FLOAT) { \
+        TIER0_DYN_FLOAT_OPERANDS() \
+        r[3] = fr[1] _op fr[2]; \
+    } else { \
+        r[3] = r[1] _op r[5]; \
+    } \
+    r[1] = r[3]; \
+
+#ifdef TIER0_THREADED_DISPATCH
+#define OP(name) op_##name:
+#define DISPATCH() inst = &code[ip++]; goto *dispatch_table[inst->op_code]
+#else
+#define OP(name) case name:
+#define DISPATCH() continue
+#endif
+
+void tier0_init(KaosIR* program)
+{
+    for (i64 i = 0; i < program->size; i++) {
+        KaosInst* inst = &program->arr[i];
+        i64** arr;
+        i64* count;
+        switch (inst->op_code) {
+        case DECLARE_LABEL:
+        case PROLOG:
+            arr = &tier0_label_ic;
+            count = &tier0_label_count;
+            break;
+        case PATCH:
+            arr = &tier0_patch_ic;
+            count = &tier0_patch_count;
+            break;
+        default:
+            continue;
+        }
+
+        i64 id = inst->op1.value.i;
+        if (id >= *count) {
+            *arr = realloc(*arr, (id + 1) * sizeof(i64));
+            for (i64 j = *count; j <= id; j++)
+                (*arr)[j] = -1;
+            *count = id + 1;
+        }
+        (*arr)[id] = i;
+    }
+}
+
+void tier0_run_main(cpu *c)
+{
+    tier0_init(c->program);
+
+    i64 end = function_table->main_start;
+    while (c->program->arr[end].op_code != HLT)
+        end++;
+
+    tier0_function* main_function = tier0_decode(c->program, function_table->main_start, end);
+    i64 back_edge_count = 0;
+    tier0_run(main_function, NULL, &back_edge_count);
+}
+
+i64 tier0_call(i64 label, i64* args, i64 arg_count)
+{
+    jit_function* function = &function_table->arr[label];
+    if (function->start == -1)
+        return 0;
+
+    function->call_count++;
+
+    // Lower the function to the JIT once it's hot, the calls that are already running stay interpreted
+    if (
+        running_cpu->tier == CPU_TIER_TIERED
+        &&
+        function->code == NULL
+        &&
+        arg_count <= TIER0_MAX_NATIVE_ARGS
+        &&
+        function->call_count + function->back_edge_count >= TIER0_HOT_THRESHOLD
+    )
+        cpu_compile_function(label);
+
+    if (function->code != NULL)
+        return tier0_call_native(function->code, args, arg_count);
+
+    if (function->tier0 == NULL)
+        function->tier0 = tier0_decode(running_cpu->program, function->start, function->end);
+
+    return tier0_run(function->tier0, args, &function->back_edge_count);
+}
+
+i64 tier0_call_native(void* code, i64* args, i64 arg_count)
+{
+    // The calling convention lets the callee ignore the surplus arguments
+    i64 a[TIER0_MAX_NATIVE_ARGS] = {0};
+    for (i64 i = 0; i < arg_count && i < TIER0_MAX_NATIVE_ARGS; i++)
+        a[i] = args[i];
+
+    tier0_native f = (tier0_native)code;
+    return f(
+        a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+        a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]
+    );
+}
+
+tier0_function* tier0_decode(KaosIR* program, i64 start, i64 end)
+{
+    tier0_function* function = malloc(sizeof *function);
+    function->size = end - start;
+    function->register_count = IR_NUM_REGISTERS;
+    function->frame_size = 0;
+    // The trailing halt returns from the function if it runs out of instructions
+    function->code = malloc((function->size + 1) * sizeof(tier0_inst));
+
+    // The stack slots are numbered program-wide, lay out the ones of this function into its frame
+    i64 slot_min = -1;
+    i64 slot_max = -1;
+    for (i64 i = start; i < end; i++) {
+        KaosInst* inst = &program->arr[i];
+        i64 slot;
+        if (inst->op_code == ALLOCAI)
+            slot = inst->op1.value.i;
+        else if (inst->op_code == REF_ALLOCAI)
+            slot = inst->op2.value.i;
+        else
+            continue;
+        if (slot_min == -1 || slot < slot_min)
+            slot_min = slot;
+        if (slot > slot_max)
+            slot_max = slot;
+    }
+
+    i64 slot_count = slot_min == -1 ? 0 : slot_max - slot_min + 1;
+    i64* slot_offsets = malloc(slot_count * sizeof(i64));
+    for (i64 i = 0; i < slot_count; i++)
+        slot_offsets[i] = -1;
+
+    for (i64 i = start; i < end; i++) {
+        KaosInst* inst = &program->arr[i];
+        if (inst->op_code != ALLOCAI || slot_offsets[inst->op1.value.i - slot_min] != -1)
+            continue;
+        slot_offsets[inst->op1.value.i - slot_min] = function->frame_size;
+        function->frame_size += (inst->op2.value.i + 15) & ~15;
+    }
+
+    for (i64 i = 0; i < slot_count; i++) {
+        if (slot_offsets[i] != -1)
+            continue;
+        slot_offsets[i] = function->frame_size;
+        function->frame_size += 2 * sizeof(long long);
+    }
+
+    for (i64 i = start; i < end; i++) {
+        KaosInst* inst = &program->arr[i];
+        tier0_inst* decoded = &function->code[i - start];
+        KaosOp* ops[4] = {&inst->op1, &inst->op2, &inst->op3, &inst->op4};
+        i64 operands[4] = {0, 0, 0, 0};
+
+        for (i64 j = 0; j < tier0_operand_count(inst->op_code); j++) {
+            operands[j] = tier0_decode_operand(ops[j]);
+            if (ops[j]->type == IR_REG && operands[j] >= function->register_count)
+                function->register_count = operands[j] + 1;
+        }
+
+        decoded->op_code = inst->op_code;
+        decoded->a = operands[0];
+        decoded->b = operands[1];
+        decoded->c = operands[2];
+        decoded->d = operands[3];
+        decoded->f = inst->op_code == FMOV ? inst->op2.value.f : 0.0;
+        decoded->target = function->size;
+
+        // Resolve the jumps into the instruction indexes local to the function
+        i64 target = -1;
+        switch (inst->op_code) {
+        case REF_ALLOCAI:
+            decoded->b = slot_offsets[decoded->b - slot_min];
+            break;
+        case DYN_LIST_KERNEL:
+            // The kernels report their errors at the line of the call
+            decoded->b = (i64)inst->ast;
+            break;
+        case DYN_LIST_INSERT:
+            decoded->a = (i64)inst->ast;
+            break;
+        case DYN_COMP_ACCESS:
+            decoded->d = (i64)inst->ast;
+            break;
+        case BEQR:
+        case BEQI:
+            if (decoded->c < tier0_patch_count)
+                target = tier0_patch_ic[decoded->c];
+            break;
+        case JMPI_FORWARD:
+            if (decoded->a < tier0_patch_count)
+                target = tier0_patch_ic[decoded->a];
+            break;
+        case JMPI:
+            if (decoded->a < tier0_label_count)
+                target = tier0_label_ic[decoded->a];
+            break;
+        default:
+            break;
+        }
+        if (target >= start && target < end)
+            decoded->target = target - start;
+    }
+
+    function->code[function->size].op_code = HLT;
+    free(slot_offsets);
+    return function;
+}
+
+i64 tier0_operand_count(i64 op_code)
+{
+    switch (op_code) {
+    case MAIN_PROLOG:
+    case PREPARE:
+    case DYN_ADD: case DYN_SUB: case DYN_MUL: case DYN_DIV: case DYN_NEG:
+    case DYN_EQR: case DYN_NER: case DYN_GTR: case DYN_LTR: case DYN_GER: case DYN_LER:
+    case DYN_LAND: case DYN_LOR: case DYN_LNOT:
+    case DYN_PRNT: case DYN_ECHO: case DYN_PRETTY_PRNT: case DYN_PRETTY_ECHO:
+    case DYN_EXIT:
+    case DYN_STR_INDEX_DELETE: case DYN_LIST_INDEX_DELETE: case DYN_DICT_KEY_DELETE:
+    case DYN_STR_INDEX_ACCESS:
+    case DYN_LIST_INDEX_UPDATE: case DYN_DICT_KEY_UPDATE:
+    case DYN_BOOL_TO_STR: case DYN_STR_TO_BOOL:
+    case DYN_NEW_LIST: case DYN_NEW_DICT:
+    case DYN_LIST_APPEND: case DYN_LIST_EXTEND: case DYN_LIST_INSERT:
+    case DYN_STR_UNSHARE: case DYN_STR_APPEND:
+    case DEBUG:
+    case HLT:
+        return 0;
+    case DECLARE_LABEL:
+    case PROLOG:
+    case RETR: case RETI:
+    case CALLR:
+    case PUTARGR: case PUTARGI:
+    case RETVAL:
+    case JMPI: case JMPI_FORWARD:
+    case PATCH:
+    case DYN_LIST_KERNEL:
+    case DYN_BREAK: case DYN_BREAK_HANDLE:
+        return 1;
+    case DECLARE_ARG:
+    case GETARG:
+    case CALL:
+    case MOVR: case MOVI: case FMOV: case FMOVR:
+    case ALLOCAI: case REF_ALLOCAI:
+    case NEGR: case FNEGR:
+    case NOTR:
+    case EXTR: case TRUNCR:
+    case DYN_GET_COMP_SIZE: case DYN_COMP_SHARE: case DYN_COMP_UNSHARE:
+        return 2;
+    case LDXR: case LDXI: case FLDXR: case FLDXI:
+    case STXR: case STXI: case FSTXR: case FSTXI:
+        return 4;
+    default:
+        return 3;
+    }
+}
+
+i64 tier0_decode_operand(KaosOp* op)
+{
+    if (op->type == IR_REG)
+        return op->reg;
+    // String literals are referenced by their address in the constant data
+    if (op->value_type == IR_STRING)
+        return (i64)op->value.s;
+    return op->value.i;
+}
+
+i64 tier0_run(tier0_function* function, i64* args, i64* back_edge_count)
+{
+    // The registers and the frame slots are on the heap of the collector, so it scans them as the JIT frames
+    i64* r = gc_alloc(function->register_count * sizeof(i64));
+    f64* fr = gc_alloc(function->register_count * sizeof(f64));
+    byte* slots = gc_alloc((function->frame_size + 1) * sizeof(byte));
+
+    i64* call_args = NULL;
+    i64 call_arg_count = 0;
+    i64 call_arg_capacity = 0;
+    i64 retval = 0;
+    i64 result = 0;
+
+    tier0_inst* code = function->code;
+    tier0_inst* inst;
+    i64 ip = 0;
+
+#ifdef TIER0_THREADED_DISPATCH
+    static void* dispatch_table[NUM_INSTRUCTIONS] = {
+        [DECLARE_LABEL] = &&op_DECLARE_LABEL,
+        [PROLOG] = &&op_PROLOG,
+        [MAIN_PROLOG] = &&op_MAIN_PROLOG,
+        [DECLARE_ARG] = &&op_DECLARE_ARG,
+        [GETARG] = &&op_GETARG,
+        [RETR] = &&op_RETR,
+        [RETI] = &&op_RETI,
+        [PREPARE] = &&op_PREPARE,
+        [CALLR] = &&op_CALLR,
+        [CALL] = &&op_CALL,
+        [PUTARGR] = &&op_PUTARGR,
+        [PUTARGI] = &&op_PUTARGI,
+        [RETVAL] = &&op_RETVAL,
+        [MOVR] = &&op_MOVR,
+        [MOVI] = &&op_MOVI,
+        [FMOV] = &&op_FMOV,
+        [FMOVR] = &&op_FMOVR,
+        [ALLOCAI] = &&op_ALLOCAI,
+        [REF_ALLOCAI] = &&op_REF_ALLOCAI,
+        [LDR] = &&op_LDR,
+        [LDXR] = &&op_LDXR,
+        [LDXI] = &&op_LDXI,
+        [FLDR] = &&op_FLDR,
+        [FLDXR] = &&op_FLDXR,
+        [FLDXI] = &&op_FLDXI,
+        [STR] = &&op_STR,
+        [STXR] = &&op_STXR,
+        [STXI] = &&op_STXI,
+        [FSTR] = &&op_FSTR,
+        [FSTXR] = &&op_FSTXR,
+        [FSTXI] = &&op_FSTXI,
+        [ADDR] = &&op_ADDR,
+        [ADDI] = &&op_ADDI,
+        [SUBR] = &&op_SUBR,
+        [SUBI] = &&op_SUBI,
+        [MULR] = &&op_MULR,
+        [MULI] = &&op_MULI,
+        [DIVR] = &&op_DIVR,
+        [DIVI] = &&op_DIVI,
+        [MODR] = &&op_MODR,
+        [MODI] = &&op_MODI,
+        [ANDR] = &&op_ANDR,
+        [ANDI] = &&op_ANDI,
+        [ORR] = &&op_ORR,
+        [ORI] = &&op_ORI,
+        [XORR] = &&op_XORR,
+        [XORI] = &&op_XORI,
+        [LSHR] = &&op_LSHR,
+        [LSHI] = &&op_LSHI,
+        [RSHR] = &&op_RSHR,
+        [RSHI] = &&op_RSHI,
+        [FADDR] = &&op_FADDR,
+        [FSUBR] = &&op_FSUBR,
+        [FMULR] = &&op_FMULR,
+        [FDIVR] = &&op_FDIVR,
+        [NEGR] = &&op_NEGR,
+        [FNEGR] = &&op_FNEGR,
+        [NOTR] = &&op_NOTR,
+        [EQR] = &&op_EQR,
+        [NER] = &&op_NER,
+        [GTR] = &&op_GTR,
+        [LTR] = &&op_LTR,
+        [GER] = &&op_GER,
+        [LER] = &&op_LER,
+        [FEQR] = &&op_FEQR,
+        [FNER] = &&op_FNER,
+        [FGTR] = &&op_FGTR,
+        [FLTR] = &&op_FLTR,
+        [FGER] = &&op_FGER,
+        [FLER] = &&op_FLER,
+        [EXTR] = &&op_EXTR,
+        [TRUNCR] = &&op_TRUNCR,
+        [BEQR] = &&op_BEQR,
+        [BEQI] = &&op_BEQI,
+        [JMPI] = &&op_JMPI,
+        [JMPI_FORWARD] = &&op_JMPI_FORWARD,
+        [PATCH] = &&op_PATCH,
+        [DYN_ADD] = &&op_DYN_ADD,
+        [DYN_SUB] = &&op_DYN_SUB,
+        [DYN_MUL] = &&op_DYN_MUL,
+        [DYN_DIV] = &&op_DYN_DIV,
+        [DYN_NEG] = &&op_DYN_NEG,
+        [DYN_EQR] = &&op_DYN_EQR,
+        [DYN_NER] = &&op_DYN_NER,
+        [DYN_GTR] = &&op_DYN_GTR,
+        [DYN_LTR] = &&op_DYN_LTR,
+        [DYN_GER] = &&op_DYN_GER,
+        [DYN_LER] = &&op_DYN_LER,
+        [DYN_LAND] = &&op_DYN_LAND,
+        [DYN_LOR] = &&op_DYN_LOR,
+        [DYN_LNOT] = &&op_DYN_LNOT,
+        [DYN_PRNT] = &&op_DYN_PRNT,
+        [DYN_ECHO] = &&op_DYN_ECHO,
+        [DYN_PRETTY_PRNT] = &&op_DYN_PRETTY_PRNT,
+        [DYN_PRETTY_ECHO] = &&op_DYN_PRETTY_ECHO,
+        [DYN_EXIT] = &&op_DYN_EXIT,
+        [DYN_STR_INDEX_DELETE] = &&op_DYN_STR_INDEX_DELETE,
+        [DYN_LIST_INDEX_DELETE] = &&op_DYN_LIST_INDEX_DELETE,
+        [DYN_DICT_KEY_DELETE] = &&op_DYN_DICT_KEY_DELETE,
+        [DYN_STR_INDEX_ACCESS] = &&op_DYN_STR_INDEX_ACCESS,
+        [DYN_COMP_ACCESS] = &&op_DYN_COMP_ACCESS,
+        [DYN_LIST_INDEX_UPDATE] = &&op_DYN_LIST_INDEX_UPDATE,
+        [DYN_DICT_KEY_UPDATE] = &&op_DYN_DICT_KEY_UPDATE,
+        [DYN_BOOL_TO_STR] = &&op_DYN_BOOL_TO_STR,
+        [DYN_STR_TO_BOOL] = &&op_DYN_STR_TO_BOOL,
+        [DYN_NEW_LIST] = &&op_DYN_NEW_LIST,
+        [DYN_NEW_DICT] = &&op_DYN_NEW_DICT,
+        [DYN_LIST_APPEND] = &&op_DYN_LIST_APPEND,
+        [DYN_LIST_EXTEND] = &&op_DYN_LIST_EXTEND,
+        [DYN_LIST_INSERT] = &&op_DYN_LIST_INSERT,
+        [DYN_LIST_KERNEL] = &&op_DYN_LIST_KERNEL,
+        [DYN_GET_COMP_SIZE] = &&op_DYN_GET_COMP_SIZE,
+        [DYN_COMP_SHARE] = &&op_DYN_COMP_SHARE,
+        [DYN_COMP_UNSHARE] = &&op_DYN_COMP_UNSHARE,
+        [DYN_COMP_UNSHARE_ELEMENT] = &&op_DYN_COMP_UNSHARE_ELEMENT,
+        [DYN_STR_UNSHARE] = &&op_DYN_STR_UNSHARE,
+        [DYN_STR_APPEND] = &&op_DYN_STR_APPEND,
+        [DYN_BREAK] = &&op_DYN_BREAK,
+        [DYN_BREAK_HANDLE] = &&op_DYN_BREAK_HANDLE,
+        [DEBUG] = &&op_DEBUG,
+        [HLT] = &&op_HLT,
+    };
+    DISPATCH();
+#else
+    for (;;) {
+        inst = &code[ip++];
+        switch (inst->op_code) {
+#endif
+    // >>> Function Declaration <<<
+    OP(DECLARE_LABEL)
+    OP(PROLOG)
+    OP(MAIN_PROLOG)
+    OP(DECLARE_ARG)
+    OP(ALLOCAI)
+    OP(PATCH)
+        DISPATCH();
+    OP(GETARG)
+        r[inst->a] = args[inst->b];
+        DISPATCH();
+    OP(RETR)
+        result = r[inst->a];
+        goto done;
+    OP(RETI)
+        result = inst->a;
+        goto done;
+    // >>> Function Calls <<<
+    OP(PREPARE)
+        call_arg_count = 0;
+        DISPATCH();
+    OP(PUTARGR)
+    OP(PUTARGI)
+        if (call_arg_count == call_arg_capacity) {
+            call_arg_capacity = call_arg_capacity == 0 ? 4 : call_arg_capacity * 2;
+            call_args = gc_realloc(call_args, call_arg_capacity * sizeof(i64));
+        }
+        call_args[call_arg_count++] = inst->op_code == PUTARGR ? r[inst->a] : inst->a;
+        DISPATCH();
+    OP(CALLR)
+        retval = tier0_call_native((void*)r[inst->a], call_args, call_arg_count);
+        DISPATCH();
+    OP(CALL)
+        retval = tier0_call(inst->a, call_args, call_arg_count);
+        DISPATCH();
+    OP(RETVAL)
+        r[inst->a] = retval;
+        DISPATCH();
+    // >>> Transfer Operations <<<
+    OP(MOVR)
+        r[inst->a] = r[inst->b];
+        DISPATCH();
+    OP(MOVI)
+        r[inst->a] = inst->b;
+        DISPATCH();
+    OP(FMOV)
+        fr[inst->a] = inst->f;
+        DISPATCH();
+    OP(FMOVR)
+        fr[inst->a] = fr[inst->b];
+        DISPATCH();
+    OP(REF_ALLOCAI)
+        r[inst->a] = (i64)(slots + inst->b);
+        DISPATCH();
+    // >>> Load Operations <<<
+    OP(LDR)
+        r[inst->a] = tier0_load(r[inst->b], inst->c);
+        DISPATCH();
+    OP(LDXR)
+        r[inst->a] = tier0_load(r[inst->b] + r[inst->c], inst->d);
+        DISPATCH();
+    OP(LDXI)
+        r[inst->a] = tier0_load(r[inst->b] + inst->c, inst->d);
+        DISPATCH();
+    OP(FLDR)
+        fr[inst->a] = tier0_fload(r[inst->b], inst->c);
+        DISPATCH();
+    OP(FLDXR)
+        fr[inst->a] = tier0_fload(r[inst->b] + r[inst->c], inst->d);
+        DISPATCH();
+    OP(FLDXI)
+        fr[inst->a] = tier0_fload(r[inst->b] + inst->c, inst->d);
+        DISPATCH();
+    // >>> Store Operations <<<
+    OP(STR)
+        tier0_store(r[inst->a], r[inst->b], inst->c);
+        DISPATCH();
+    OP(STXR)
+        tier0_store(r[inst->a] + r[inst->b], r[inst->c], inst->d);
+        DISPATCH();
+    OP(STXI)
+        tier0_store(r[inst->a] + inst->b, r[inst->c], inst->d);
+        DISPATCH();
+    OP(FSTR)
+        tier0_fstore(r[inst->a], fr[inst->b], inst->c);
+        DISPATCH();
+    OP(FSTXR)
+        tier0_fstore(r[inst->a] + r[inst->b], fr[inst->c], inst->d);
+        DISPATCH();
+    OP(FSTXI)
+        tier0_fstore(r[inst->a] + inst->b, fr[inst->c], inst->d);
+        DISPATCH();
+    // >>> Binary Arithmetic Operations <<<
+    OP(ADDR)
+        r[inst->a] = r[inst->b] + r[inst->c];
+        DISPATCH();
+    OP(ADDI)
+        r[inst->a] = r[inst->b] + inst->c;
+        DISPATCH();
+    OP(SUBR)
+        r[inst->a] = r[inst->b] - r[inst->c];
+        DISPATCH();
+    OP(SUBI)
+        r[inst->a] = r[inst->b] - inst->c;
+        DISPATCH();
+    OP(MULR)
+        r[inst->a] = r[inst->b] * r[inst->c];
+        DISPATCH();
+    OP(MULI)
+        r[inst->a] = r[inst->b] * inst->c;
+        DISPATCH();
+    OP(DIVR)
+        r[inst->a] = r[inst->b] / r[inst->c];
+        DISPATCH();
+    OP(DIVI)
+        r[inst->a] = r[inst->b] / inst->c;
+        DISPATCH();
+    OP(MODR)
+        r[inst->a] = r[inst->b] % r[inst->c];
+        DISPATCH();
+    OP(MODI)
+        r[inst->a] = r[inst->b] % inst->c;
+        DISPATCH();
+    OP(ANDR)
+        r[inst->a] = r[inst->b] & r[inst->c];
+        DISPATCH();
+    OP(ANDI)
+        r[inst->a] = r[inst->b] & inst->c;
+        DISPATCH();
+    OP(ORR)
+        r[inst->a] = r[inst->b] | r[inst->c];
+        DISPATCH();
+    OP(ORI)
+        r[inst->a] = r[inst->b] | inst->c;
+        DISPATCH();
+    OP(XORR)
+        r[inst->a] = r[inst->b] ^ r[inst->c];
+        DISPATCH();
+    OP(XORI)
+        r[inst->a] = r[inst->b] ^ inst->c;
+        DISPATCH();
+    OP(LSHR)
+        r[inst->a] = (i64)((u64)r[inst->b] << r[inst->c]);
+        DISPATCH();
+    OP(LSHI)
+        r[inst->a] = (i64)((u64)r[inst->b] << inst->c);
+        DISPATCH();
+    OP(RSHR)
+        r[inst->a] = r[inst->b] >> r[inst->c];
+        DISPATCH();
+    OP(RSHI)
+        r[inst->a] = r[inst->b] >> inst->c;
+        DISPATCH();
+    // >>> Binary Floating-point Arithmetic Operations <<<
+    OP(FADDR)
+        fr[inst->a] = fr[inst->b] + fr[inst->c];
+        DISPATCH();
+    OP(FSUBR)
+        fr[inst->a] = fr[inst->b] - fr[inst->c];
+        DISPATCH();
+    OP(FMULR)
+        fr[inst->a] = fr[inst->b] * fr[inst->c];
+        DISPATCH();
+    OP(FDIVR)
+        fr[inst->a] = fr[inst->b] / fr[inst->c];
+        DISPATCH();
+    // >>> Unary Arithmetic Operations <<<
+    OP(NEGR)
+        r[inst->a] = -r[inst->b];
+        DISPATCH();
+    OP(FNEGR)
+        fr[inst->a] = -fr[inst->b];
+        DISPATCH();
+    OP(NOTR)
+        r[inst->a] = ~r[inst->b];
+        DISPATCH();
+    // >>> Compare Instructions <<<
+    OP(EQR)
+        r[inst->a] = r[inst->b] == r[inst->c];
+        DISPATCH();
+    OP(NER)
+        r[inst->a] = r[inst->b] != r[inst->c];
+        DISPATCH();
+    OP(GTR)
+        r[inst->a] = r[inst->b] > r[inst->c];
+        DISPATCH();
+    OP(LTR)
+        r[inst->a] = r[inst->b] < r[inst->c];
+        DISPATCH();
+    OP(GER)
+        r[inst->a] = r[inst->b] >= r[inst->c];
+        DISPATCH();
+    OP(LER)
+        r[inst->a] = r[inst->b] <= r[inst->c];
+        DISPATCH();
+    OP(FEQR)
+        r[inst->a] = fr[inst->b] == fr[inst->c];
+        DISPATCH();
+    OP(FNER)
+        r[inst->a] = fr[inst->b] != fr[inst->c];
+        DISPATCH();
+    OP(FGTR)
+        r[inst->a] = fr[inst->b] > fr[inst->c];
+        DISPATCH();
+    OP(FLTR)
+        r[inst->a] = fr[inst->b] < fr[inst->c];
+        DISPATCH();
+    OP(FGER)
+        r[inst->a] = fr[inst->b] >= fr[inst->c];
+        DISPATCH();
+    OP(FLER)
+        r[inst->a] = fr[inst->b] <= fr[inst->c];
+        DISPATCH();
+    // >>> Conversions <<<
+    OP(EXTR)
+        fr[inst->a] = (f64)r[inst->b];
+        DISPATCH();
+    OP(TRUNCR)
+        r[inst->a] = (i64)fr[inst->b];
+        DISPATCH();
+    // >>> Branch Operations & Jumps <<<
+    OP(BEQR)
+        if (r[inst->a] == r[inst->b])
+            ip = inst->target;
+        DISPATCH();
+    OP(BEQI)
+        if (r[inst->a] == inst->b)
+            ip = inst->target;
+        DISPATCH();
+    OP(JMPI)
+        // A backward jump is a loop iteration
+        if (inst->target < ip)
+            (*back_edge_count)++;
+        ip = inst->target;
+        DISPATCH();
+    OP(JMPI_FORWARD)
+        ip = inst->target;
+        DISPATCH();
+    // >>> Non-Atomic Instructions <<<
+    // Dynamic Arithmetic
+    OP(DYN_ADD)
+        if (r[0] == V_STRING && r[4] == V_STRING) {
+            r[1] = cpu_string_concat(r[1], r[5]);
+            DISPATCH();
+        }
+        TIER0_DYN_BINARY_ARITH(+);
+        DISPATCH();
+    OP(DYN_SUB)
+        TIER0_DYN_BINARY_ARITH(-);
+        DISPATCH();
+    OP(DYN_MUL)
+        TIER0_DYN_BINARY_ARITH(*);
+        DISPATCH();
+    OP(DYN_DIV)
+        TIER0_DYN_BINARY_ARITH(/);
+        DISPATCH();
+    OP(DYN_NEG)
+        if (r[0] == V_FLOAT)
+            fr[1] = -fr[1];
+        else
+            r[1] = -r[1];
+        DISPATCH();
+    // Dynamic Comparison
+    OP(DYN_EQR)
+        TIER0_DYN_BINARY_COMPARISON(==);
+        DISPATCH();
+    OP(DYN_NER)
+        TIER0_DYN_BINARY_COMPARISON(!=);
+        DISPATCH();
+    OP(DYN_GTR)
+        TIER0_DYN_BINARY_COMPARISON(>);
+        DISPATCH();
+    OP(DYN_LTR)
+        TIER0_DYN_BINARY_COMPARISON(<);
+        DISPATCH();
+    OP(DYN_GER)
+        TIER0_DYN_BINARY_COMPARISON(>=);
+        DISPATCH();
+    OP(DYN_LER)
+        TIER0_DYN_BINARY_COMPARISON(<=);
+        DISPATCH();
+    // Dynamic Logic
+    OP(DYN_LAND)
+        r[1] = r[1] > 0;
+        if (r[1] != 0)
+            r[1] = r[5] > 0;
+        DISPATCH();
+    OP(DYN_LOR)
+        r[1] = r[1] > 0;
+        if (r[1] == 0)
+            r[1] = r[5] > 0;
+        DISPATCH();
+    OP(DYN_LNOT)
+        if (r[0] == V_FLOAT)
+            r[1] = (i64)fr[1];
+        r[1] = (r[1] > 0) ^ 0x00000001;
+        DISPATCH();
+    // Dynamic Printing
+    OP(DYN_PRNT)
+        cpu_print(r[0], r[1], fr[1], 1, 0);
+        DISPATCH();
+    OP(DYN_ECHO)
+        cpu_print(r[0], r[1], fr[1], 0, 0);
+        DISPATCH();
+    OP(DYN_PRETTY_PRNT)
+        cpu_print(r[0], r[1], fr[1], 1, 1);
+        DISPATCH();
+    OP(DYN_PRETTY_ECHO)
+        cpu_print(r[0], r[1], fr[1], 0, 1);
+        DISPATCH();
+    // Dynamic Exit
+    OP(DYN_EXIT)
+        cpu_exit(r[1]);
+    // Dynamic Index Delete
+    OP(DYN_STR_INDEX_DELETE)
+        cpu_delete_string_index(r[1], r[11]);
+        DISPATCH();
+    OP(DYN_LIST_INDEX_DELETE)
+        cpu_delete_list_index(r[1], r[11]);
+        DISPATCH();
+    OP(DYN_DICT_KEY_DELETE)
+        cpu_delete_dict_key(r[1], r[11]);
+        DISPATCH();
+    // Dynamic Index Access
+    OP(DYN_STR_INDEX_ACCESS)
+        // Turn negative index into positive index
+        if (r[1] <= -1) {
+            r[2] = tier0_load(r[5], sizeof(size_t));
+            r[1] = r[2] + r[1];
+        }
+        r[4] = r[1] * sizeof(char) + sizeof(size_t);
+        DISPATCH();
+    OP(DYN_COMP_ACCESS)
+        r[2] = cpu_composite_element(inst->d, r[inst->a], r[inst->b], r[inst->c]);
+        DISPATCH();
+    // Dynamic Index Update
+    OP(DYN_LIST_INDEX_UPDATE)
+        cpu_list_index_update(r[12], r[13], r[0], r[1], fr[1]);
+        DISPATCH();
+    OP(DYN_DICT_KEY_UPDATE)
+        cpu_dict_key_update(r[12], r[13], r[0], r[1], fr[1]);
+        DISPATCH();
+    // Dynamic Type Conversion
+    OP(DYN_BOOL_TO_STR)
+        r[1] = cpu_boolean_to_string(r[1]);
+        DISPATCH();
+    OP(DYN_STR_TO_BOOL)
+        r[1] = cpu_string_to_boolean(r[1]);
+        DISPATCH();
+    // Dynamic Create New List
+    OP(DYN_NEW_LIST)
+        cpu_new_list(r[1], r[2]);
+        DISPATCH();
+    OP(DYN_NEW_DICT)
+        cpu_new_dict(r[1], r[2]);
+        DISPATCH();
+    // Dynamic Grow List
+    OP(DYN_LIST_APPEND)
+        cpu_list_append(r[12], r[0], r[1], fr[1]);
+        DISPATCH();
+    OP(DYN_LIST_EXTEND)
+        cpu_list_extend(r[12], r[1]);
+        DISPATCH();
+    OP(DYN_LIST_INSERT)
+        cpu_list_insert(inst->a, r[12], r[13], r[0], r[1], fr[1]);
+        DISPATCH();
+    // Dynamic Vectorized List Kernels
+    OP(DYN_LIST_KERNEL)
+        r[2] = simd_run_kernel(inst->a, inst->b, r[12], r[0], r[1], fr[1]);
+        DISPATCH();
+    // Dynamic Composite Helpers
+    OP(DYN_GET_COMP_SIZE)
+        r[inst->a] = cpu_get_composite_len(r[inst->b]);
+        DISPATCH();
+    OP(DYN_COMP_SHARE)
+        r[inst->b] = cpu_composite_share(r[inst->a], r[inst->b]);
+        DISPATCH();
+    OP(DYN_COMP_UNSHARE)
+        r[inst->b] = cpu_composite_unshare(r[inst->a], r[inst->b]);
+        DISPATCH();
+    OP(DYN_COMP_UNSHARE_ELEMENT)
+        cpu_composite_unshare_element(r[inst->a], r[inst->b], r[inst->c]);
+        DISPATCH();
+    // Dynamic String Helpers
+    OP(DYN_STR_UNSHARE)
+        r[1] = cpu_string_unshare(r[1]);
+        DISPATCH();
+    OP(DYN_STR_APPEND)
+        r[1] = cpu_string_append(r[1], r[5]);
+        DISPATCH();
+    // Dynamic Loop Break
+    OP(DYN_BREAK)
+        break_current_loop = inst->a;
+        DISPATCH();
+    OP(DYN_BREAK_HANDLE)
+        r[inst->a] = break_current_loop;
+        DISPATCH();
+    // Debug
+    OP(DEBUG)
+        tier0_debug(r, fr);
+        DISPATCH();
+    OP(HLT)
+        goto done;
+#ifndef TIER0_THREADED_DISPATCH
+        default:
+            goto done;
+        }
+    }
+#endif
+
+done:
+    gc_free(r);
+    gc_free(fr);
+    gc_free(slots);
+    gc_free(call_args);
+    return result;
+}
+
+i64 tier0_load(i64 addr, i64 size)
+{
+    switch (size) {
+    case 1:
+        return *(signed char*)addr;
+    case 2:
+        return *(short*)addr;
+    case 4:
+        return *(int*)addr;
+    default:
+        return *(i64*)addr;
+    }
+}
+
+void tier0_store(i64 addr, i64 value, i64 size)
+{
+    switch (size) {
+    case 1:
+        *(signed char*)addr = value;
+        break;
+    case 2:
+        *(short*)addr = value;
+        break;
+    case 4:
+        *(int*)addr = value;
+        break;
+    default:
+        *(i64*)addr = value;
+        break;
+    }
+}
+
+f64 tier0_fload(i64 addr, i64 size)
+{
+    if (size == sizeof(float))
+        return *(float*)addr;
+    return *(f64*)addr;
+}
+
+void tier0_fstore(i64 addr, f64 value, i64 size)
+{
+    if (size == sizeof(float))
+        *(float*)addr = value;
+    else
+        *(f64*)addr = value;
+}
+
+void tier0_debug(i64* r, f64* fr)
+{
+    printf(" ----------------------------------------------------------\n");
+    for (i64 i = 0; i < 12; i++)
+        printf(i == 11 ? "[R%lld: %lld] |" : "[R%lld: %lld] ", i, r[i]);
+    for (i64 i = 0; i < 4; i++)
+        printf(i == 3 ? "[FR%lld: %lf]" : "[FR%lld: %lf] ", i, fr[i]);
+    printf("\n");
+}
@@ -0,0 +1,73 @@
+/*
+ * Description: Tier 0 IR interpreter of the Chaos Programming Language's source
+ *
+ * Copyright (c) 2019-2021 Chaos Language Development Authority <info@chaos-lang.org>
+ *
+ * License: GNU General Public License v3.0
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>
+ *
+ * Authors: M. Mert Yildiran <me@mertyildiran.com>
+ */
+
+#ifndef TIER0_H
+#define TIER0_H
+
+#include "cpu.h"
+
+// A function is lowered to the JIT once its calls and loop iterations add up to this
+#define TIER0_HOT_THRESHOLD 1000
+// The JIT-compiled functions are called through a fixed signature with this many arguments
+#define TIER0_MAX_NATIVE_ARGS 16
+
+#if defined(__GNUC__)
+#define TIER0_THREADED_DISPATCH
+#endif
+
+typedef struct tier0_inst {
+    i64 op_code;
+    i64 a;
+    i64 b;
+    i64 c;
+    i64 d;
+    f64 f;
+    i64 target;
+} tier0_inst;
+
+typedef struct tier0_function {
+    tier0_inst* code;
+    i64 size;
+    i64 register_count;
+    i64 frame_size;
+} tier0_function;
+
+typedef i64 (*tier0_native)(
+    i64, i64, i64, i64, i64, i64, i64, i64,
+    i64, i64, i64, i64, i64, i64, i64, i64
+);
+
+void tier0_init(KaosIR* program);
+void tier0_run_main(cpu *c);
+i64 tier0_call(i64 label, i64* args, i64 arg_count);
+i64 tier0_call_native(void* code, i64* args, i64 arg_count);
+tier0_function* tier0_decode(KaosIR* program, i64 start, i64 end);
+i64 tier0_operand_count(i64 op_code);
+i64 tier0_decode_operand(KaosOp* op);
+i64 tier0_run(tier0_function* function, i64* args, i64* back_edge_count);
+i64 tier0_load(i64 addr, i64 size);
+void tier0_store(i64 addr, i64 value, i64 size);
+f64 tier0_fload(i64 addr, i64 size);
+void tier0_fstore(i64 addr, f64 value, i64 size);
+void tier0_debug(i64* r, f64* fr);
+
+#endif
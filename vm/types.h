@@ -23,6 +23,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stdbool.h>
+
 #define byte unsigned char
 #define u64 unsigned long long
 #define i64 long long
@@ -31,6 +33,8 @@
 typedef struct KaosIR KaosIR;
 typedef struct KaosInst KaosInst;
 
+enum CpuTier { CPU_TIER_JIT, CPU_TIER_INTERPRETER, CPU_TIER_TIERED };
+
 
 typedef struct {
     KaosIR* program;
@@ -38,13 +42,23 @@ typedef struct {
     // instruction counter
     i64 ic;
 
-    // stack
+    // stack offsets of the ALLOCAI slots, grows on demand
     int* stack;
+    i64 stack_capacity;
 
     // current instruction
     KaosInst* inst;
 
     unsigned short debug_level;
+
+    // lower the functions on their first call instead of upfront
+    bool lazy_jit;
+
+    // run the functions in the IR interpreter and lower only the hot ones
+    enum CpuTier tier;
+
+    // print the garbage collector statistics after the run
+    bool gc_stats;
 } cpu;
 
 #endif